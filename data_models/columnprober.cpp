@@ -0,0 +1,204 @@
+#include "data_models/columnprober.h"
+#include "data_models/tablemanager.h"
+#include "media/danmakuconverter.h"
+#include "media/fragmentindex.h"
+#include <QDateTime>
+#include <QFileInfo>
+#include <QPointer>
+#include <QScrollBar>
+#include <QTableView>
+#include <QThread>
+#include <QTimer>
+
+namespace {
+
+const int kBatchSize = 16;
+
+// 由短边推算B站清晰度代码（竖屏视频按短边计）
+int qualityFromResolution(int width, int height)
+{
+    const int shortSide = qMin(width, height);
+    if (shortSide >= 4320) return 127;
+    if (shortSide >= 2160) return 120;
+    if (shortSide >= 1080) return 80;
+    if (shortSide >= 720) return 64;
+    if (shortSide >= 480) return 32;
+    if (shortSide >= 360) return 16;
+    return shortSide > 0 ? 6 : 0;
+}
+
+} // namespace
+
+// ===================== 构造函数/析构函数 =====================
+ColumnProber::ColumnProber(TableManager* tableManager, QTableView* tableView, QObject* parent)
+    : QObject(parent)
+    , m_tableManager(tableManager)
+    , m_tableView(tableView)
+    , m_visibleTimer(new QTimer(this))
+{
+    // 探测以读盒子头部为主，两个线程足够，避免与混流争抢磁盘
+    m_pool.setMaxThreadCount(2);
+
+    // 滚动/缩放时合并为一次可见范围计算
+    m_visibleTimer->setSingleShot(true);
+    m_visibleTimer->setInterval(30);
+    connect(m_visibleTimer, &QTimer::timeout, this, &ColumnProber::queueVisibleRows);
+
+    if (m_tableView) {
+        connect(m_tableView->verticalScrollBar(), &QScrollBar::valueChanged,
+                this, &ColumnProber::scheduleVisible);
+        connect(m_tableView->verticalScrollBar(), &QScrollBar::rangeChanged,
+                this, &ColumnProber::scheduleVisible);
+    }
+}
+
+ColumnProber::~ColumnProber()
+{
+    m_urgent.clear();
+    m_background.clear();
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+// ===================== 队列管理 =====================
+void ColumnProber::enqueue(quint64 id)
+{
+    m_background.append(id);
+    scheduleVisible();
+}
+
+void ColumnProber::clear()
+{
+    m_urgent.clear();
+    m_background.clear();
+    m_inFlight.clear();
+    m_batchRunning = false;
+    ++m_generation;
+}
+
+void ColumnProber::scheduleVisible()
+{
+    if (!m_visibleTimer->isActive()) {
+        m_visibleTimer->start();
+    }
+}
+
+void ColumnProber::queueVisibleRows()
+{
+    QAbstractItemModel* viewModel = m_tableView ? m_tableView->model() : nullptr;
+    if (viewModel && viewModel->rowCount() > 0) {
+        const int viewportHeight = m_tableView->viewport()->height();
+        int first = m_tableView->rowAt(0);
+        int last = m_tableView->rowAt(viewportHeight - 1);
+        if (first < 0) first = 0;
+        if (last < 0) last = viewModel->rowCount() - 1;
+
+        // 可见行重新排到最前面（逆序插入保持自上而下的顺序）；视图行可能经过筛选/排序
+        for (int row = last; row >= first; --row) {
+            VideoItem* item = m_tableManager->videoItemAt(m_tableManager->sourceRow(viewModel->index(row, 0)));
+            if (item && !item->isProbed() && !m_inFlight.contains(item->id())) {
+                m_urgent.removeOne(item->id());
+                m_urgent.prepend(item->id());
+            }
+        }
+    }
+    pump();
+}
+
+void ColumnProber::pump()
+{
+    if (m_batchRunning) return;
+
+    // VideoItem 只能在GUI线程访问，先取出文件列表
+    QList<Job> jobs;
+    while (jobs.size() < kBatchSize && (!m_urgent.isEmpty() || !m_background.isEmpty())) {
+        const quint64 id = !m_urgent.isEmpty() ? m_urgent.takeFirst() : m_background.takeFirst();
+        VideoItem* item = m_tableManager->videoItemById(id);
+        if (!item || item->isProbed() || m_inFlight.contains(id)) continue;
+
+        Job job;
+        job.id = id;
+        job.contentFiles = item->contentFiles();
+        job.videoPath = item->segmentFiles().isEmpty() ? item->videoPath() : QString();
+        job.cacheKey = job.contentFiles.join('|');
+
+        // 命中缓存直接填入
+        auto cached = m_cache.constFind(job.cacheKey);
+        if (cached != m_cache.constEnd()) {
+            apply(id, *cached);
+            continue;
+        }
+        jobs.append(job);
+    }
+    if (jobs.isEmpty()) return;
+
+    for (const Job& job : jobs) {
+        m_inFlight.insert(job.id);
+    }
+    m_batchRunning = true;
+
+    QPointer<ColumnProber> self(this);
+    const quint64 generation = m_generation;
+    m_pool.start([self, jobs, generation]() {
+        QThread::currentThread()->setPriority(QThread::LowPriority);
+
+        QList<ProbeResult> results;
+        for (const Job& job : jobs) {
+            if (!self) return;
+            results.append(probe(job.contentFiles, job.videoPath));
+        }
+        if (!self) return;
+
+        QMetaObject::invokeMethod(self.data(), [self, jobs, results, generation]() {
+            if (generation != self->m_generation) return;
+            for (int i = 0; i < jobs.size(); ++i) {
+                self->m_cache.insert(jobs[i].cacheKey, results[i]);
+                self->m_inFlight.remove(jobs[i].id);
+                self->apply(jobs[i].id, results[i]);
+            }
+            self->m_batchRunning = false;
+            self->pump();
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ColumnProber::apply(quint64 id, const ProbeResult& result)
+{
+    VideoItem* item = m_tableManager->videoItemById(id);
+    if (!item) return;
+
+    // 只补全导入时未知的列，不覆盖缓存元数据给出的值
+    if (item->totalSize() <= 0) item->setTotalSize(result.totalSize);
+    if (item->duration() <= 0) item->setDuration(result.duration);
+    if (item->qualityId() <= 0) item->setQualityId(result.qualityId);
+    if (item->danmakuCount() < 0) item->setDanmakuCount(result.danmakuCount);
+    if (item->danmakuUpdate() <= 0) item->setDanmakuUpdate(result.danmakuUpdate);
+    item->markProbed();
+}
+
+// ===================== 探测 =====================
+ProbeResult ColumnProber::probe(const QStringList& contentFiles, const QString& videoPath)
+{
+    ProbeResult result;
+    for (const QString& path : contentFiles) {
+        result.totalSize += QFileInfo(path).size();
+    }
+
+    // 分片索引只跳读盒子头部；分段FLV没有可用的索引，时长留空
+    if (!videoPath.isEmpty()) {
+        FragmentIndex index;
+        if (index.build(videoPath)) {
+            const double seconds = index.isFragmented() ? index.playableDuration() : index.declaredDuration();
+            result.duration = qRound(seconds);
+            result.qualityId = qualityFromResolution(index.width(), index.height());
+        }
+    }
+
+    const QString danmakuPath = DanmakuConverter::findForVideo(
+        videoPath.isEmpty() && !contentFiles.isEmpty() ? contentFiles.first() : videoPath);
+    if (!danmakuPath.isEmpty()) {
+        result.danmakuCount = DanmakuConverter::countComments(danmakuPath);
+        result.danmakuUpdate = QFileInfo(danmakuPath).lastModified().toMSecsSinceEpoch();
+    }
+    return result;
+}
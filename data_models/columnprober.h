@@ -0,0 +1,68 @@
+#ifndef COLUMNPROBER_H
+#define COLUMNPROBER_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+#include <QThreadPool>
+
+class QTableView;
+class QTimer;
+class TableManager;
+
+// 需要读文件才能得到的列：时长、总大小、清晰度、弹幕数/更新时间
+struct ProbeResult {
+    qint64 totalSize = 0;      // 字节
+    int duration = 0;          // 秒
+    int qualityId = 0;         // 由视频分辨率推算的 qn
+    int danmakuCount = -1;
+    qint64 danmakuUpdate = 0;  // 弹幕文件修改时间（毫秒）
+};
+
+// 按需补全耗时列：
+// 1. 进入视口的行优先探测（滚动、增删行后重新计算可见范围）
+// 2. 其余行在低优先级线程中逐批探测
+// 结果按文件列表缓存，同一内容重新导入时不再读文件
+class ColumnProber : public QObject
+{
+    Q_OBJECT
+public:
+    ColumnProber(TableManager* tableManager, QTableView* tableView, QObject* parent = nullptr);
+    ~ColumnProber();
+
+    // 新增的行进入后台队列
+    void enqueue(quint64 id);
+    void clear();
+
+    // 在工作线程中执行
+    static ProbeResult probe(const QStringList& contentFiles, const QString& videoPath);
+
+private:
+    struct Job {
+        quint64 id = 0;
+        QString cacheKey;
+        QStringList contentFiles;
+        QString videoPath;
+    };
+
+    void scheduleVisible();
+    void queueVisibleRows();
+    void pump();
+    void apply(quint64 id, const ProbeResult& result);
+
+    TableManager* m_tableManager;
+    QTableView* m_tableView;
+    QTimer* m_visibleTimer;
+    QThreadPool m_pool;
+
+    QList<quint64> m_urgent;      // 可见行
+    QList<quint64> m_background;  // 其余行
+    QSet<quint64> m_inFlight;
+    QHash<QString, ProbeResult> m_cache;
+    bool m_batchRunning = false;
+    quint64 m_generation = 0;     // clear() 后丢弃旧批次的结果
+};
+
+#endif // COLUMNPROBER_H
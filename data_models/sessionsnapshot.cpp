@@ -0,0 +1,143 @@
+#include "data_models/sessionsnapshot.h"
+#include "data_models/stringpool.h"
+#include "data_models/tablemanager.h"
+#include "managers/applog.h"
+#include <QDataStream>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace {
+
+const QDataStream::Version kStreamVersion = QDataStream::Qt_6_5;
+
+} // namespace
+
+// ===================== 字符串表 =====================
+quint32 SnapshotStringTable::id(const QString& value)
+{
+    auto it = m_ids.constFind(value);
+    if (it != m_ids.constEnd()) {
+        return *it;
+    }
+    const quint32 newId = quint32(m_strings.size());
+    m_strings.append(value);
+    m_ids.insert(value, newId);
+    return newId;
+}
+
+// ===================== 保存 =====================
+QString SessionSnapshot::defaultPath()
+{
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    return QDir(dir).filePath("session.msnap");
+}
+
+QByteArray SessionSnapshot::serialize(const TableManager& tableManager)
+{
+    // 行记录先写入单独的缓冲区，字符串表在遍历过程中才能确定
+    SnapshotStringTable strings;
+    QByteArray records;
+    {
+        QDataStream out(&records, QIODevice::WriteOnly);
+        out.setVersion(kStreamVersion);
+        for (const VideoItem* item : tableManager.videoItems()) {
+            item->writeSnapshot(out, strings);
+        }
+    }
+
+    const quint32 visibleMask = tableManager.columnManager().visibleMask() & ColumnSchema::PersistedMask;
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(kStreamVersion);
+    out << Magic << Version << visibleMask << tableManager.headerState()
+        << strings.strings() << quint32(tableManager.rowCount());
+    out.writeRawData(records.constData(), int(records.size()));
+    return data;
+}
+
+bool SessionSnapshot::writeFile(const QString& path, const QByteArray& data)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    // 先写临时文件再替换，写到一半退出不会损坏上一次的快照
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(lcSession) << "无法写入会话快照:" << path << file.errorString();
+        return false;
+    }
+    file.write(data);
+    return file.commit();
+}
+
+// ===================== 恢复 =====================
+bool SessionSnapshot::restore(TableManager& tableManager, const QString& path)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly) || file.size() == 0) {
+        return false;
+    }
+
+    // 映射文件，QDataStream 直接读映射内存；映射失败时退回一次性读取
+    QByteArray data;
+    uchar* mapped = file.map(0, file.size());
+    if (mapped) {
+        data = QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), file.size());
+    } else {
+        data = file.readAll();
+    }
+
+    QDataStream in(data);
+    in.setVersion(kStreamVersion);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if (magic != Magic || version != Version) {
+        qCWarning(lcSession) << "会话快照格式或版本不符，忽略:" << path << "版本" << version;
+        return false;
+    }
+
+    quint32 visibleMask = 0;
+    QByteArray headerState;
+    QStringList strings;
+    quint32 count = 0;
+    in >> visibleMask >> headerState >> strings >> count;
+    if (in.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    // 字符串表中的目录/昵称/系列先驻留一次，各行直接共享
+    for (QString& value : strings) {
+        value = StringPool::intern(value);
+    }
+
+    QList<VideoItem*> items;
+    items.reserve(int(qMin<quint32>(count, quint32(file.size() / 32 + 1))));
+    for (quint32 i = 0; i < count; ++i) {
+        VideoItem* item = new VideoItem(&tableManager);
+        if (!item->readSnapshot(in, strings)) {
+            delete item;
+            qDeleteAll(items);
+            qCWarning(lcSession) << "会话快照已损坏，忽略:" << path;
+            return false;
+        }
+        items.append(item);
+    }
+
+    // 列布局：只取可选列的位，强制列始终可见
+    tableManager.columnManager().setVisibleMask(visibleMask & ColumnSchema::PersistedMask);
+    tableManager.updateTableHeaders();
+    tableManager.addRows(items);
+    tableManager.restoreHeaderState(headerState);
+
+    qCDebug(lcSession) << "会话快照已恢复:" << items.size() << "行，耗时" << timer.elapsed() << "ms";
+    return true;
+}
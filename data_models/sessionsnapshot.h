@@ -0,0 +1,46 @@
+#ifndef SESSIONSNAPSHOT_H
+#define SESSIONSNAPSHOT_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+class TableManager;
+
+// 快照中的字符串表：目录、UP主、系列在大量行中重复，只写一次，条目中保存序号（0 为空串）
+class SnapshotStringTable
+{
+public:
+    SnapshotStringTable() { m_strings.append(QString()); m_ids.insert(QString(), 0); }
+
+    quint32 id(const QString& value);
+    const QStringList& strings() const { return m_strings; }
+
+private:
+    QHash<QString, quint32> m_ids;
+    QStringList m_strings;
+};
+
+// 表格会话快照：全部 VideoItem 字段、列布局与每行状态，保存为带版本号的二进制文件
+// 文件格式（QDataStream，Qt_6_5，大端）：
+//   quint32 魔数 'MSNP' | quint32 版本 | quint32 可见列位掩码 | QByteArray 表头状态
+//   QStringList 字符串表 | quint32 行数 | 行记录 × 行数（见 VideoItem::writeSnapshot）
+// 读取时通过 QFile::map 映射文件，不复制整个文件，也不访问源视频文件
+class SessionSnapshot
+{
+public:
+    static const quint32 Magic = 0x4D534E50;  // 'MSNP'
+    static const quint32 Version = 2;  // 2：模型包含全部列，表头状态含隐藏列
+
+    static QString defaultPath();
+
+    // 在GUI线程中序列化当前表格（读取 VideoItem）
+    static QByteArray serialize(const TableManager& tableManager);
+    // 原子写入文件，可在工作线程中执行
+    static bool writeFile(const QString& path, const QByteArray& data);
+    // 读取快照并追加到表格；文件不存在或格式/版本不符时返回 false，表格不变
+    static bool restore(TableManager& tableManager, const QString& path);
+};
+
+#endif // SESSIONSNAPSHOT_H
@@ -0,0 +1,40 @@
+#include "data_models/stringpool.h"
+#include <QMutex>
+#include <QSet>
+
+namespace {
+
+QMutex& poolMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+QSet<QString>& pool()
+{
+    static QSet<QString> strings;
+    return strings;
+}
+
+} // namespace
+
+QString StringPool::intern(const QString& value)
+{
+    if (value.isEmpty()) {
+        return QString();
+    }
+
+    // 扫描在后台线程中进行，加锁保证安全
+    QMutexLocker locker(&poolMutex());
+    auto it = pool().constFind(value);
+    if (it != pool().constEnd()) {
+        return *it;
+    }
+    return *pool().insert(value);
+}
+
+int StringPool::size()
+{
+    QMutexLocker locker(&poolMutex());
+    return pool().size();
+}
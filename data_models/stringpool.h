@@ -0,0 +1,16 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <QString>
+
+// 字符串驻留池：UP主昵称、系列名、缓存目录等在成千上万行中重复出现，
+// 驻留后所有行共享同一份隐式共享数据，每行只占一个指针
+class StringPool
+{
+public:
+    // 返回池中与 value 相等的共享实例（不存在则加入），空串直接返回
+    static QString intern(const QString& value);
+    static int size();
+};
+
+#endif // STRINGPOOL_H
@@ -3,6 +3,7 @@
 #include <QVector>
 #include <QStringList>
 #include <QSet>
+#include <iterator>
 
 // 表格列枚举定义（按显示顺序）
 enum TableColumns {
@@ -30,19 +31,119 @@ enum TableColumns {
     TOTAL_COLUMNS       // 总列数 (16列)
 };
 
+// 单元格的显示方式
+enum ColumnDelegate : quint8 {
+    DelegateText,       // 普通文本
+    DelegateRowNumber,  // 序号，按行位置计算（见 TableManager 的表格模型）
+    DelegateProgress    // 进度条（ProgressBarDelegate）
+};
+
+enum ColumnFlag : quint8 {
+    ColumnForced         = 0x1,  // 强制显示，不可隐藏
+    ColumnDefaultVisible = 0x2,  // 可选列的默认显示状态
+    ColumnEditable       = 0x4,  // 可在表格中直接编辑
+    ColumnInteractive    = 0x8,  // 列宽由用户拖动（路径列），其余按内容自适应
+    ColumnPersisted      = 0x10  // 显示状态写入会话快照（即可选列）
+};
+
+// 列描述：表头、显示/编辑属性与委托，模型、表头、快照都从这张表生成
+struct ColumnDescriptor {
+    TableColumns column;
+    const char* name;         // 表头（UTF-8）
+    quint8 flags;
+    ColumnDelegate delegate;
+
+    constexpr bool has(ColumnFlag flag) const { return (flags & flag) != 0; }
+};
+
+inline constexpr ColumnDescriptor kColumnTable[] = {
+    {COL_INDEX,          "序号",               ColumnForced,                          DelegateRowNumber},
+    {COL_VIDEO_TYPE,     "视频类型",           ColumnDefaultVisible | ColumnPersisted, DelegateText},
+    {COL_TITLE,          "视频标题",           ColumnForced | ColumnEditable,         DelegateText},
+    {COL_CREATE_TIME,    "创建时间",           ColumnDefaultVisible | ColumnPersisted, DelegateText},
+    {COL_DURATION,       "视频时长",           ColumnForced,                          DelegateText},
+    {COL_TOTAL_SIZE,     "文件大小",           ColumnForced,                          DelegateText},
+    {COL_QUALITY,        "清晰度",             ColumnForced,                          DelegateText},
+    {COL_PROGRESS,       "混流进度",           ColumnForced,                          DelegateProgress},
+    {COL_VIDEO_FILE,     "视频文件导入(m4s)",  ColumnForced | ColumnInteractive,      DelegateText},
+    {COL_AUDIO_FILE,     "音频文件导入(m4s)",  ColumnForced | ColumnInteractive,      DelegateText},
+    {COL_UP_NAME,        "UP主",               ColumnPersisted,                       DelegateText},
+    {COL_UP_UID,         "UP主UID",            ColumnPersisted,                       DelegateText},
+    {COL_SERIES,         "所属系列",           ColumnPersisted,                       DelegateText},
+    {COL_AV_NUMBER,      "视频av/bv号",        ColumnPersisted,                       DelegateText},
+    {COL_DANMAKU_UPDATE, "弹幕更新时间(最近)", ColumnPersisted,                       DelegateText},
+    {COL_DANMAKU_COUNT,  "最新弹幕数",         ColumnPersisted,                       DelegateText},
+};
+
+// 编译期查询（列号即表中下标）
+namespace ColumnSchema {
+
+constexpr bool isOrdered()
+{
+    for (int i = 0; i < int(std::size(kColumnTable)); ++i) {
+        if (kColumnTable[i].column != i) return false;
+    }
+    return true;
+}
+static_assert(std::size(kColumnTable) == TOTAL_COLUMNS, "kColumnTable 必须覆盖全部列");
+static_assert(isOrdered(), "kColumnTable 必须按 TableColumns 顺序排列");
+static_assert(TOTAL_COLUMNS <= 32, "列掩码为32位");
+
+constexpr const ColumnDescriptor& descriptor(TableColumns column) { return kColumnTable[column]; }
+constexpr quint32 bit(TableColumns column) { return 1u << column; }
+
+constexpr quint32 maskOf(ColumnFlag flag)
+{
+    quint32 mask = 0;
+    for (const ColumnDescriptor& d : kColumnTable) {
+        if (d.has(flag)) mask |= bit(d.column);
+    }
+    return mask;
+}
+
+inline constexpr quint32 AllMask = (1u << TOTAL_COLUMNS) - 1;
+inline constexpr quint32 ForcedMask = maskOf(ColumnForced);
+inline constexpr quint32 OptionalMask = AllMask & ~ForcedMask;
+inline constexpr quint32 PersistedMask = maskOf(ColumnPersisted);
+inline constexpr quint32 DefaultVisibleMask = ForcedMask | maskOf(ColumnDefaultVisible);
+
+constexpr bool isValid(TableColumns column) { return column >= 0 && column < TOTAL_COLUMNS; }
+constexpr bool isForced(TableColumns column) { return isValid(column) && (ForcedMask & bit(column)); }
+constexpr bool isEditable(TableColumns column) { return isValid(column) && descriptor(column).has(ColumnEditable); }
+
+// 使用指定委托的列，没有时返回 TOTAL_COLUMNS
+constexpr TableColumns columnWith(ColumnDelegate delegate)
+{
+    for (const ColumnDescriptor& d : kColumnTable) {
+        if (d.delegate == delegate) return d.column;
+    }
+    return TOTAL_COLUMNS;
+}
+
+} // namespace ColumnSchema
+
+// 列显示状态（可见列位掩码），列的静态属性见 kColumnTable
 class ColumnManager
 {
 public:
-    ColumnManager();
+    ColumnManager() = default;
 
     // 设置列可见性（强制列不可修改）
     void setColumnVisibility(TableColumns column, bool visible);
-    bool isColumnVisible(TableColumns column) const;
+    bool isColumnVisible(TableColumns column) const {
+        return ColumnSchema::isValid(column) && (m_visibleMask & ColumnSchema::bit(column));
+    }
+
+    // 可见列位掩码（会话快照使用），设置时强制列始终可见
+    quint32 visibleMask() const { return m_visibleMask; }
+    void setVisibleMask(quint32 mask) { m_visibleMask = (mask & ColumnSchema::AllMask) | ColumnSchema::ForcedMask; }
 
     // 获取所有可见列的标题列表
     QStringList getVisibleHeaders() const;
+    // 获取全部列的标题列表（按列号顺序，表格模型使用）
+    QStringList getAllHeaders() const;
 
-    // 获取列在实际表格中的位置索引
+    // 获取列在可见列中的位置索引
     int getVisualIndex(TableColumns column) const;
 
     // 获取所有可选列的类型
@@ -52,11 +153,7 @@ public:
     QString getColumnName(TableColumns column) const;
 
 private:
-    bool isForcedColumn(TableColumns column) const;
-
-private:
-    QVector<bool> columnVisibility;
-    QStringList columnNames;
+    quint32 m_visibleMask = ColumnSchema::DefaultVisibleMask;
 };
 
 #endif // TABLECOLUMNS_H
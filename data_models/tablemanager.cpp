@@ -1,25 +1,32 @@
 #include "tablemanager.h"
 #include <QHeaderView>
 #include <QStyle>
-#include <QSettings>
 #include <QDir>
 #include <QStandardPaths>
+#include <algorithm>
 #include "delegates/progressbardelegate.h"
+#include "data_models/columnprober.h"
+#include "data_models/videofilter.h"
+#include "managers/settingsstore.h"
+#include "managers/applog.h"
 
 // ===================== 构造函数/析构函数 =====================
 TableManager::TableManager(QTableView* tableView, QObject *parent)
     : QObject(parent)
     , m_tableView(tableView)
-    , m_tableModel(new QStandardItemModel(this))
+    , m_tableModel(new VideoTableModel(this, this))
     , m_progressDelegate(nullptr)
 {
+    m_proxy = new VideoFilterProxy(this, this);
+    m_proxy->setSourceModel(m_tableModel);
 
     if (m_tableView) {
-        m_tableView->setModel(m_tableModel);
-        qDebug() << "Model set to table view in constructor";
+        m_tableView->setModel(m_proxy);
+        qCDebug(lcTable) << "Model set to table view in constructor";
     }
+    m_prober = new ColumnProber(this, m_tableView, this);
 
-    qDebug() << "TableManager initialized."; // 调试点9
+    qCDebug(lcTable) << "TableManager initialized."; // 调试点9
     // 初始化代码
 }
 
@@ -31,55 +38,51 @@ TableManager::~TableManager()
 // ===================== 初始化函数 =====================
 void TableManager::initTableView()
 {
-    qDebug() << "========== TABLE INITIALIZATION START ==========";
-    qDebug() << "TableView address:" << m_tableView;
-    qDebug() << "TableView model:" << m_tableView->model();
-    qDebug() << "Our model:" << m_tableModel;
+    qCDebug(lcTable) << "========== TABLE INITIALIZATION START ==========";
+    qCDebug(lcTable) << "TableView address:" << m_tableView;
+    qCDebug(lcTable) << "TableView model:" << m_tableView->model();
+    qCDebug(lcTable) << "Our model:" << m_tableModel;
 
     if (!m_tableView) {
-        qCritical() << "TableView is null in initTableView!";
+        qCCritical(lcTable) << "TableView is null in initTableView!";
         return;
     } else {
-        qDebug() << "TableView is valid:" << m_tableView;
+        qCDebug(lcTable) << "TableView is valid:" << m_tableView;
     }
 
     // 添加空指针检查
     if (!m_tableView || !m_tableModel) {
-        qCritical() << "CRITICAL: TableView or TableModel is null!";
+        qCCritical(lcTable) << "CRITICAL: TableView or TableModel is null!";
         return;
     }
 
     // 确保模型已创建
     if (!m_tableModel) {
-        qDebug() << "Creating new table model";
-        m_tableModel = new QStandardItemModel(this);
+        qCDebug(lcTable) << "Creating new table model";
+        m_tableModel = new VideoTableModel(this, this);
     } else {
-        qDebug() << "Table model already exists";
+        qCDebug(lcTable) << "Table model already exists";
     }
 
-    qDebug() << "TableManager::initTableView start";
-    qDebug() << "m_tableView:" << m_tableView;
-    qDebug() << "m_tableModel:" << m_tableModel;
-    qDebug() << "m_videoItems size:" << m_videoItems.size(); // 新增调试输出
+    qCDebug(lcTable) << "TableManager::initTableView start";
+    qCDebug(lcTable) << "m_tableView:" << m_tableView;
+    qCDebug(lcTable) << "m_tableModel:" << m_tableModel;
+    qCDebug(lcTable) << "m_videoItems size:" << m_videoItems.size(); // 新增调试输出
 
     // 先清空原有数据，防止残留
     clearModelData();
 
     // 初始化表头
-    qDebug() << "Updating table headers";
+    qCDebug(lcTable) << "Updating table headers";
     updateTableHeaders(); // 这里可能是崩溃点
-    qDebug() << "Table headers updated"; // 如果崩溃，可能不会打印这条
+    qCDebug(lcTable) << "Table headers updated"; // 如果崩溃，可能不会打印这条
 
-    qDebug() << "Setting model to table view";
-    // 设置表格模型
-    m_tableView->setModel(m_tableModel);
-    qDebug() << "Model set to table view";
-
-    // 确保设置模型到视图
-    if (m_tableView && m_tableModel) {
-        m_tableView->setModel(m_tableModel);
-        qDebug() << "Model set to table view";
+    qCDebug(lcTable) << "Setting model to table view";
+    // 设置表格模型（视图显示筛选层，数据仍在 m_tableModel 中）
+    if (m_tableView->model() != m_proxy) {
+        m_tableView->setModel(m_proxy);
     }
+    qCDebug(lcTable) << "Model set to table view";
 
     // 添加交替行颜色
     m_tableView->setAlternatingRowColors(true);
@@ -89,6 +92,10 @@ void TableManager::initTableView()
     m_tableView->setSelectionMode(QAbstractItemView::ExtendedSelection);
     m_tableView->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
     m_tableView->verticalHeader()->setVisible(false);
+
+    // 点击表头排序；初始不排序，保持导入顺序
+    m_tableView->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
+    m_tableView->setSortingEnabled(true);
     // 修改后：仅允许双击编辑
     m_tableView->setEditTriggers(QAbstractItemView::DoubleClicked | QAbstractItemView::EditKeyPressed);
 
@@ -99,104 +106,37 @@ void TableManager::initTableView()
                     "}";
     m_tableView->setStyleSheet(style);
 
-    // 启用标题编辑
-    connect(m_tableModel, &QStandardItemModel::itemChanged, this, [this](QStandardItem *item) {
-        int row = item->row();
-        if (row < m_videoItems.size()) {
-            TableColumns colType = m_currentColumnsOrder[item->column()];
-            if (colType == COL_TITLE) {
-                m_videoItems[row]->setTitle(item->text());
-            }
-        }
-    });
+    // 标题编辑由 VideoTableModel::setData 直接写入 VideoItem
 
-    qDebug() << "========== TABLE INITIALIZATION COMPLETE ==========";
+    qCDebug(lcTable) << "========== TABLE INITIALIZATION COMPLETE ==========";
 }
 
 void TableManager::initPathMemory()
 {
-    qDebug() << "Initializing path memory...";
-    loadPathSettings();
-
-    qDebug() << "Path memory initialized.";
-    qDebug() << "Last output path:" << m_lastOutputPath;
+    qCDebug(lcTable) << "Initializing path memory...";
+    qCDebug(lcTable) << "Path memory initialized.";
+    qCDebug(lcTable) << "Last output path:" << lastOutputPath();
 }
 
 // ===================== 表视图更新函数 =====================
 void TableManager::updateTableRow(int rowIndex)
 {
-    if (rowIndex < 0 || rowIndex >= m_videoItems.size() || rowIndex >= m_tableModel->rowCount())
+    if (rowIndex < 0 || rowIndex >= m_videoItems.size())
         return;
 
-    VideoItem* item = m_videoItems[rowIndex];
-    for (int col = 0; col < m_tableModel->columnCount(); ++col) {
-        TableColumns colType = m_currentColumnsOrder[col];
-        QStandardItem* tableItem = m_tableModel->item(rowIndex, col);
-
-        if (colType == COL_PROGRESS) {
-            int progress = item->data(colType).toInt();
-            tableItem->setData(progress, Qt::DisplayRole);
-        } else {
-            tableItem->setText(item->data(colType).toString());
-        }
-    }
+    // 模型不保存单元格，只需通知视图重新取这一行
+    m_tableModel->rowsChanged(rowIndex, rowIndex);
 }
 
 void TableManager::updateTableHeaders()
 {
-    qDebug() << "updateTableHeaders start";
-
-    // 保存当前行数和列数
-    int rowCount = m_tableModel->rowCount();
-    int oldColumnCount = m_tableModel->columnCount();
-    qDebug() << "Current row count:" << rowCount << "Old column count:" << oldColumnCount;
+    qCDebug(lcTable) << "updateTableHeaders start";
 
-
-    // 获取可见列标题
-    QStringList headers = m_columnManager.getVisibleHeaders();
-    qDebug() << "Visible headers count:" << headers.size();
-
-
-    // 更新当前列的顺序列表
-    m_currentColumnsOrder.clear();
-    for (int i = 0; i < TOTAL_COLUMNS; ++i) {
-        TableColumns column = static_cast<TableColumns>(i);
-        if (m_columnManager.isColumnVisible(column)) {
-            m_currentColumnsOrder.append(column);
-        }
-    }
-    qDebug() << "Current columns order size:" << m_currentColumnsOrder.size();
-
-    // 设置新表头
-    m_tableModel->setColumnCount(headers.size());
-    m_tableModel->setHorizontalHeaderLabels(headers);
-    qDebug() << "Set column count and header labels";
-
-    // 添加新列（如果列数增加）
-    for (int row = 0; row < rowCount; ++row) {
-        for (int col = oldColumnCount; col < headers.size(); ++col) {
-            QStandardItem* item = new QStandardItem();
-            TableColumns colType = m_currentColumnsOrder[col];
-            qDebug() << "Creating new item for row:" << row << "col:" << col << "type:" << colType;
-
-            if (colType == COL_PROGRESS) {
-                item->setData(0, Qt::DisplayRole);
-            } else if (colType == COL_TITLE) {
-                item->setFlags(item->flags() | Qt::ItemIsEditable);
-            } else {
-                item->setFlags(item->flags() & ~Qt::ItemIsEditable);
-            }
-
-            m_tableModel->setItem(row, col, item);
-        }
-        updateTableRow(row);
-    }
-    qDebug() << "Added new columns if necessary";
+    // 模型始终包含全部列（列号即 TableColumns），表头标签由模型按列号给出
 
     // 设置列宽策略
-    for (int col = 0; col < m_currentColumnsOrder.size(); ++col) {
-        TableColumns colType = m_currentColumnsOrder[col];
-        if (colType == COL_VIDEO_FILE || colType == COL_AUDIO_FILE) {
+    for (int col = 0; col < TOTAL_COLUMNS; ++col) {
+        if (kColumnTable[col].has(ColumnInteractive)) {
             m_tableView->horizontalHeader()->setSectionResizeMode(
                 col, QHeaderView::Interactive);
             m_tableView->setColumnWidth(col, 150);
@@ -208,133 +148,190 @@ void TableManager::updateTableHeaders()
         }
     }
 
-    // 设置进度条委托
-    int progressCol = m_columnManager.getVisualIndex(COL_PROGRESS);
-    qDebug() << "Setting delegate for progress column:" << progressCol;
-
-    if (progressCol >= 0) {
-        // 不再手动删除委托，由Qt自动管理生命周期
-        QAbstractItemDelegate* oldDelegate = m_tableView->itemDelegateForColumn(progressCol);
-        if (oldDelegate) {
-            qDebug() << "Removing old delegate:" << oldDelegate;
-            m_tableView->setItemDelegateForColumn(progressCol, nullptr);
-            // 注意：不要删除oldDelegate！Qt会管理其生命周期
-        }
+    // 设置进度条委托（进度列位置固定，只需设置一次）
+    static_assert(ColumnSchema::columnWith(DelegateProgress) != TOTAL_COLUMNS, "缺少进度列");
+    if (!m_progressDelegate) {
+        qCDebug(lcTable) << "Creating new progress delegate";
+        m_progressDelegate = new ProgressBarDelegate(this);
+        m_tableView->setItemDelegateForColumn(ColumnSchema::columnWith(DelegateProgress), m_progressDelegate);
+    }
+
+    applyColumnVisibility();
+}
 
-        // 确保委托对象存在，仅在需要时创建委托
-        if (!m_progressDelegate) {
-            qDebug() << "Creating new progress delegate";
-            m_progressDelegate = new ProgressBarDelegate(this);
+void TableManager::applyColumnVisibility()
+{
+    // 只切换表头分区的隐藏状态，与行数无关
+    for (int col = 0; col < TOTAL_COLUMNS; ++col) {
+        const bool hidden = !m_columnManager.isColumnVisible(TableColumns(col));
+        if (m_tableView->isColumnHidden(col) != hidden) {
+            m_tableView->setColumnHidden(col, hidden);
         }
+    }
+}
 
-        qDebug() << "Setting progress delegate:" << m_progressDelegate;
-        // 设置委托（无需删除旧委托）
-        m_tableView->setItemDelegateForColumn(progressCol, m_progressDelegate);
+void TableManager::setColumnVisible(TableColumns column, bool visible)
+{
+    m_columnManager.setColumnVisibility(column, visible);
+    if (column >= 0 && column < TOTAL_COLUMNS) {
+        m_tableView->setColumnHidden(column, !m_columnManager.isColumnVisible(column));
     }
+    ++m_revision;  // 列布局也保存在会话快照中
 }
 
-void TableManager::updateRowNumbers()
+QList<TableColumns> TableManager::currentColumnsOrder() const
 {
-    for (int i = 0; i < m_videoItems.size(); ++i) {
-        m_videoItems[i]->setIndex(i + 1);
-        updateTableRow(i);
+    QList<TableColumns> columns;
+    for (int col = 0; col < TOTAL_COLUMNS; ++col) {
+        if (m_columnManager.isColumnVisible(TableColumns(col))) {
+            columns.append(TableColumns(col));
+        }
     }
+    return columns;
 }
 
 
 // ===================== 数据操作函数 =====================
 void TableManager::clearModelData()
 {
-    // 1. 先保存当前可见的表头标签
-    QStringList savedHeaders = m_columnManager.getVisibleHeaders();
-    const int oldColumnCount = savedHeaders.size();
-
-    // 2. 清除数据
-    m_tableModel->clear();
+    m_tableModel->beginResetItems();
     qDeleteAll(m_videoItems);
     m_videoItems.clear();
+    m_rowById.clear();
+    if (m_prober) m_prober->clear();
+    if (m_proxy) m_proxy->reset();
+    m_tableModel->endResetItems();
+    ++m_revision;
 
-    // 3. 恢复表头结构（列数和标签）
-    m_tableModel->setColumnCount(oldColumnCount);
-    m_tableModel->setHorizontalHeaderLabels(savedHeaders); // ✅ 关键修复：重新设置表头标签
+    // 重置模型会重建表头分区，需重新应用隐藏状态
+    if (m_tableView) applyColumnVisibility();
 
-    qDebug() << "Model cleared, headers restored";
+    qCDebug(lcTable) << "Model cleared";
 }
 
 void TableManager::addNewRow(VideoItem* item)
 {
-    qDebug() << "------------------ Adding New Table Row ------------------";
-    qDebug() << "Item Index:" << item->index();
-    qDebug() << "Current Rows:" << m_videoItems.size();
+    qCDebug(lcTable) << "Adding row, item ID:" << item->id() << "current rows:" << m_videoItems.size();
 
-    m_videoItems.append(item);
+    appendModelRow(item);
+}
 
-    // 添加新行到模型
-    QList<QStandardItem*> rowItems;
-    for (int col = 0; col < m_currentColumnsOrder.size(); ++col) {
-        TableColumns colType = m_currentColumnsOrder[col];
-        QStandardItem* tableItem = new QStandardItem();
-        tableItem->setTextAlignment(Qt::AlignCenter);
-
-        // 仅初始化标题列，其他列保持空
-        if (colType == COL_TITLE) {
-            tableItem->setFlags(tableItem->flags() | Qt::ItemIsEditable);
-            tableItem->setText("<新项目>");
-        } else {
-            tableItem->setFlags(tableItem->flags() & ~Qt::ItemIsEditable);
-        }
+void TableManager::appendModelRow(VideoItem* item)
+{
+    m_tableModel->beginAppendRows(1);
+    trackItem(item);
+    m_tableModel->endAppendRows();
+    ++m_revision;
+}
 
-        rowItems.append(tableItem);
-    }
-    m_tableModel->appendRow(rowItems);
+void TableManager::trackItem(VideoItem* item)
+{
+    m_rowById.insert(item->id(), m_videoItems.size());
+    m_videoItems.append(item);
+    m_proxy->itemAdded(item);
 
     // 连接数据变化信号 - 使用唯一连接避免重复
-    connect(item, &VideoItem::dataChanged, this, [this, item]()
+    const quint64 id = item->id();
+    connect(item, &VideoItem::dataChanged, this, [this, id]()
     {
-        int row = m_videoItems.indexOf(item);
-        if (row >= 0) updateTableRow(row);
+        int row = rowOfId(id);
+        if (row < 0) return;
+        // 先更新筛选索引，单元格刷新时筛选层据此重新判断该行
+        m_proxy->itemChanged(m_videoItems[row]);
+        updateTableRow(row);
+        ++m_revision;
     }
     );
 
-    updateRowNumbers();
-    qDebug() << "Row Added Successfully";
+    if (m_prober && !item->isProbed()) {
+        m_prober->enqueue(item->id());
+    }
+}
+
+void TableManager::addRows(const QList<VideoItem*>& items)
+{
+    if (items.isEmpty()) return;
+
+    // 逐行追加会让筛选层逐行更新映射；这里只发出一次 rowsInserted
+    // （不断开代理，表头的隐藏列、列宽模式和排序标记保持不变）
+    m_tableModel->beginAppendRows(items.size());
+    m_videoItems.reserve(m_videoItems.size() + items.size());
+    m_rowById.reserve(m_videoItems.size() + items.size());
+    for (VideoItem* item : items) {
+        trackItem(item);
+    }
+    m_tableModel->endAppendRows();
+    ++m_revision;
+    qCDebug(lcTable) << "Rows added in batch:" << items.size();
+}
+
+QByteArray TableManager::headerState() const
+{
+    return m_tableView ? m_tableView->horizontalHeader()->saveState() : QByteArray();
+}
+
+void TableManager::restoreHeaderState(const QByteArray& state)
+{
+    if (m_tableView && !state.isEmpty()) {
+        m_tableView->horizontalHeader()->restoreState(state);
+    }
 }
 
 // 在tablemanager.cpp中实现这些方法
 void TableManager::removeRow(int row)
 {
-    qDebug() << "------------------ Removing Table Row ------------------";
-    qDebug() << "Removing Row:" << row;
-    qDebug() << "Current Rows:" << m_videoItems.size();
+    qCDebug(lcTable) << "Removing row:" << row << "current rows:" << m_videoItems.size();
 
     if (row < 0 || row >= m_videoItems.size())
         return;
 
-    delete m_videoItems.takeAt(row);
-    m_tableModel->removeRow(row);
-    updateRowNumbers();
-    qDebug() << "Row Removed Successfully";
+    m_tableModel->beginRemoveItemRows(row, 1);
+    VideoItem* item = m_videoItems.takeAt(row);
+    m_rowById.remove(item->id());
+    m_proxy->itemRemoved(item->id());
+    delete item;
+    m_tableModel->endRemoveItemRows();
+    reindexRows(row);
+    ++m_revision;
 }
 
 void TableManager::removeSelectedRows(const QModelIndexList& selected)
 {
     if (selected.isEmpty()) return;
 
-    // 倒序删除避免索引问题
+    // 选中的是视图行，换算为源模型行号
     QList<int> rows;
     for (const QModelIndex &index : selected) {
-        rows.append(index.row());
+        const int row = sourceRow(index);
+        if (row >= 0 && row < m_videoItems.size()) rows.append(row);
     }
+    if (rows.isEmpty()) return;
 
-    std::sort(rows.begin(), rows.end(), std::greater<int>());
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
 
-    for (int row : rows) {
-        if (row < m_videoItems.size()) {
-            delete m_videoItems.takeAt(row);
-            m_tableModel->removeRow(row);
+    // 按连续区间从后往前删除：每个区间只触发一次 rowsRemoved，而不是每行一次
+    int end = rows.size();
+    while (end > 0) {
+        int first = end - 1;
+        while (first > 0 && rows[first - 1] == rows[first] - 1) {
+            --first;
+        }
+        const int startRow = rows[first];
+        const int count = end - first;
+
+        m_tableModel->beginRemoveItemRows(startRow, count);
+        for (int row = startRow; row < startRow + count; ++row) {
+            m_rowById.remove(m_videoItems[row]->id());
+            m_proxy->itemRemoved(m_videoItems[row]->id());
+            delete m_videoItems[row];
         }
+        m_videoItems.remove(startRow, count);
+        m_tableModel->endRemoveItemRows();
+        end = first;
     }
-    updateRowNumbers();
+    reindexRows(rows.first());
+    ++m_revision;
 }
 
 void TableManager::removeAllRows()
@@ -344,23 +341,22 @@ void TableManager::removeAllRows()
 
 void TableManager::addVideoItem(const QString& videoPath,const QString& audioPath,const QString& title)
 {
-    qDebug() << "Adding new video item via TableManager:";
-    qDebug() << "  Video Path:" << videoPath;
-    qDebug() << "  Audio Path:" << audioPath;
-    qDebug() << "  Title:" << title;
+    qCDebug(lcTable) << "Adding new video item via TableManager:";
+    qCDebug(lcTable) << "  Video Path:" << videoPath;
+    qCDebug(lcTable) << "  Audio Path:" << audioPath;
+    qCDebug(lcTable) << "  Title:" << title;
 
     // 创建新行对象
-    int newIndex = m_videoItems.size() + 1;
-    VideoItem* newItem = new VideoItem(newIndex, this);
+    VideoItem* newItem = new VideoItem(this);
     newItem->setHasError(false);
 
     // 设置数据
     newItem->setTitle(title);
     if (!videoPath.isEmpty()) {
-        newItem->setData(COL_VIDEO_FILE, videoPath);
+        newItem->setVideoPath(videoPath);
     }
     if (!audioPath.isEmpty()) {
-        newItem->setData(COL_AUDIO_FILE, audioPath);
+        newItem->setAudioPath(audioPath);
     }
 
     // 使用 TableManager 添加新行
@@ -369,31 +365,45 @@ void TableManager::addVideoItem(const QString& videoPath,const QString& audioPat
 
 
 // ===================== 路径管理函数 =====================
-void TableManager::loadPathSettings()
+QString TableManager::lastVideoPath() const
+{
+    return SettingsStore::instance().value(SettingKeys::LastVideoPath, QDir::homePath());
+}
+
+QString TableManager::lastAudioPath() const
+{
+    return SettingsStore::instance().value(SettingKeys::LastAudioPath, QDir::homePath());
+}
+
+QString TableManager::lastOutputPath() const
 {
-    QSettings settings;
-    m_lastVideoPath = settings.value("Last/VideoPath", QDir::homePath()).toString();
-    m_lastAudioPath = settings.value("Last/AudioPath", QDir::homePath()).toString();
-    m_lastOutputPath = settings.value("Last/OutputPath",
-                                      QStandardPaths::writableLocation(QStandardPaths::DownloadLocation)).toString();
-    m_lastTitleFolderPath = settings.value("Last/TitleFolderPath", QDir::homePath()).toString();
+    return SettingsStore::instance().value(SettingKeys::LastOutputPath,
+                                           QStandardPaths::writableLocation(QStandardPaths::DownloadLocation));
+}
 
-    qDebug() << "Loaded path settings:";
-    qDebug() << "  VideoPath:" << m_lastVideoPath;
-    qDebug() << "  AudioPath:" << m_lastAudioPath;
-    qDebug() << "  OutputPath:" << m_lastOutputPath;
-    qDebug() << "  TitleFolderPath:" << m_lastTitleFolderPath;
+QString TableManager::lastTitleFolderPath() const
+{
+    return SettingsStore::instance().value(SettingKeys::LastTitleFolderPath, QDir::homePath());
 }
 
-void TableManager::savePathSettings()
+void TableManager::setLastVideoPath(const QString& path)
 {
-    QSettings settings;
-    settings.setValue("Last/VideoPath", m_lastVideoPath);
-    settings.setValue("Last/AudioPath", m_lastAudioPath);
-    settings.setValue("Last/OutputPath", m_lastOutputPath);
-    settings.setValue("Last/TitleFolderPath", m_lastTitleFolderPath);
+    SettingsStore::instance().setValue(SettingKeys::LastVideoPath, path);
+}
 
-    qDebug() << "Saved path settings.";
+void TableManager::setLastAudioPath(const QString& path)
+{
+    SettingsStore::instance().setValue(SettingKeys::LastAudioPath, path);
+}
+
+void TableManager::setLastOutputPath(const QString& path)
+{
+    SettingsStore::instance().setValue(SettingKeys::LastOutputPath, path);
+}
+
+void TableManager::setLastTitleFolderPath(const QString& path)
+{
+    SettingsStore::instance().setValue(SettingKeys::LastTitleFolderPath, path);
 }
 
 
@@ -410,10 +420,52 @@ int TableManager::rowCount() const
     return m_videoItems.size();
 }
 
+int TableManager::sourceRow(const QModelIndex& viewIndex) const
+{
+    if (!viewIndex.isValid()) return -1;
+    if (viewIndex.model() == m_proxy) {
+        return m_proxy->mapToSource(viewIndex).row();
+    }
+    return viewIndex.row();
+}
+
+QList<VideoItem*> TableManager::visibleItems() const
+{
+    if (!m_proxy->isFiltering() && m_proxy->sortColumn() < 0) {
+        return QList<VideoItem*>(m_videoItems.cbegin(), m_videoItems.cend());
+    }
+
+    QList<VideoItem*> items;
+    items.reserve(m_proxy->rowCount());
+    for (int row = 0; row < m_proxy->rowCount(); ++row) {
+        if (VideoItem* item = videoItemAt(m_proxy->mapToSource(m_proxy->index(row, 0)).row())) {
+            items.append(item);
+        }
+    }
+    return items;
+}
+
+void TableManager::setFilter(const QString& query, quint8 stateMask)
+{
+    m_proxy->setFilter(query, stateMask);
+}
+
+VideoItem* TableManager::videoItemById(quint64 id) const
+{
+    return videoItemAt(rowOfId(id));
+}
+
+void TableManager::reindexRows(int firstRow)
+{
+    for (int row = qMax(0, firstRow); row < m_videoItems.size(); ++row) {
+        m_rowById[m_videoItems[row]->id()] = row;
+    }
+}
+
 void TableManager::performDeleteOperation(DeleteMode mode)
 {
     if (!m_tableView) {
-        qCritical() << "TableView is null in performDeleteOperation!";
+        qCCritical(lcTable) << "TableView is null in performDeleteOperation!";
         return;
     }
 
@@ -428,20 +480,26 @@ void TableManager::performDeleteOperation(DeleteMode mode)
         removeAllRows();
         break;
     default:
-        qWarning() << "Unknown delete mode:" << mode;
+        qCWarning(lcTable) << "Unknown delete mode:" << mode;
     }
 }
 
 void TableManager::updateVideoItem(int row, TableColumns column, const QVariant& value) {
     if (row >=0 && row < m_videoItems.size()) {
         m_videoItems[row]->setData(column, value);
+        m_proxy->itemChanged(m_videoItems[row]);
+        updateTableRow(row);
+        ++m_revision;
+        if (m_prober && !m_videoItems[row]->isProbed()) {
+            m_prober->enqueue(m_videoItems[row]->id());
+        }
     }
 }
 
-TableColumns TableManager::columnTypeAt(int visualIndex) const
+TableColumns TableManager::columnTypeAt(int column) const
 {
-    if (visualIndex >= 0 && visualIndex < m_currentColumnsOrder.size()) {
-        return m_currentColumnsOrder[visualIndex];
+    if (column >= 0 && column < TOTAL_COLUMNS) {
+        return TableColumns(column);
     }
     return TOTAL_COLUMNS;
 }
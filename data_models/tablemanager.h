@@ -2,13 +2,16 @@
 #define TABLEMANAGER_H
 
 #include <QObject>
-#include <QStandardItemModel>
+#include <QHash>
 #include <QTableView>
 #include "tablecolumns.h"
 #include "videoitem.h"
+#include "videotablemodel.h"
 #include "delegates/deletemode.h"
 
 class ProgressBarDelegate;
+class ColumnProber;
+class VideoFilterProxy;
 
 class TableManager : public QObject
 {
@@ -19,35 +22,46 @@ public:
 
     void initTableView();
     void updateTableHeaders();
+    // 按 ColumnManager 的设置显示/隐藏可选列（只改表头分区，不改模型）
+    void applyColumnVisibility();
+    void setColumnVisible(TableColumns column, bool visible);
     void updateTableRow(int rowIndex);
-    void updateRowNumbers();
     void clearModelData();
     void addVideoItem(const QString& videoPath, const QString& audioPath, const QString& title);
     void addNewRow(VideoItem* item);
+    // 批量追加（恢复会话等）：一次插入全部行，筛选/排序层只处理一次插入和一次数据变化
+    void addRows(const QList<VideoItem*>& items);
+
+    // 列宽/排序等表头状态（会话快照使用）
+    QByteArray headerState() const;
+    void restoreHeaderState(const QByteArray& state);
+    // 表格内容每次变化后递增，用于判断是否需要重新保存快照
+    quint64 revision() const { return m_revision; }
 
     // 路径管理功能
     void initPathMemory();
-    void loadPathSettings();
-    void savePathSettings();
 
-    // 路径访问器
-    QString lastVideoPath() const { return m_lastVideoPath; }
-    QString lastAudioPath() const { return m_lastAudioPath; }
-    QString lastOutputPath() const { return m_lastOutputPath; }
-    QString lastTitleFolderPath() const { return m_lastTitleFolderPath; }
+    // 路径访问器（读写 SettingsStore，修改后由其延迟写回）
+    QString lastVideoPath() const;
+    QString lastAudioPath() const;
+    QString lastOutputPath() const;
+    QString lastTitleFolderPath() const;
 
     // 路径设置器
-    void setLastVideoPath(const QString& path) { m_lastVideoPath = path; }
-    void setLastAudioPath(const QString& path) { m_lastAudioPath = path; }
-    void setLastOutputPath(const QString& path) { m_lastOutputPath = path; }
-    void setLastTitleFolderPath(const QString& path) { m_lastTitleFolderPath = path; }
+    void setLastVideoPath(const QString& path);
+    void setLastAudioPath(const QString& path);
+    void setLastOutputPath(const QString& path);
+    void setLastTitleFolderPath(const QString& path);
 
     // 其他原有方法保持不变...
     QVector<VideoItem*>& videoItems() { return m_videoItems; }
     const QVector<VideoItem*>& videoItems() const { return m_videoItems; }
-    QStandardItemModel* tableModel() { return m_tableModel; }
+    VideoTableModel* tableModel() { return m_tableModel; }
+    VideoFilterProxy* filterProxy() { return m_proxy; }
     ColumnManager& columnManager() { return m_columnManager; }
-    QList<TableColumns> currentColumnsOrder() const { return m_currentColumnsOrder; }
+    const ColumnManager& columnManager() const { return m_columnManager; }
+    // 当前显示的列（按列号顺序）
+    QList<TableColumns> currentColumnsOrder() const;
     void removeRow(int row);
     void removeSelectedRows(const QModelIndexList& selected);
     void removeAllRows();
@@ -55,22 +69,38 @@ public:
     VideoItem* videoItemAt(int row) const;
     int rowCount() const;
 
+    // 视图中的索引（经过筛选/排序）→ 源模型行号，即 videoItemAt() 使用的行号
+    int sourceRow(const QModelIndex& viewIndex) const;
+    // 当前筛选条件下可见的项目（按显示顺序），未筛选时为全部项目
+    QList<VideoItem*> visibleItems() const;
+    // 筛选：query 语法见 VideoFilterProxy::setFilter，stateMask 为 VideoStateFlag 组合
+    void setFilter(const QString& query, quint8 stateMask);
+
+    // 按行ID查找（O(1)），行已删除时返回 nullptr / -1
+    VideoItem* videoItemById(quint64 id) const;
+    int rowOfId(quint64 id) const { return m_rowById.value(id, -1); }
+
     void updateVideoItem(int row, TableColumns column, const QVariant& value); // 新增
-    TableColumns columnTypeAt(int visualIndex) const;
+    // 模型列号 → 列类型；模型列号与 TableColumns 一一对应，隐藏列不改变列号
+    TableColumns columnTypeAt(int column) const;
 
 private:
+    // 从 firstRow 开始重建 行ID→行号 索引（增删行后调用）
+    void reindexRows(int firstRow);
+    // 登记 item（行ID索引、筛选索引、数据变化信号、列探测），供单行/批量添加共用
+    void trackItem(VideoItem* item);
+    // 为 item 追加模型行（不输出调试信息）
+    void appendModelRow(VideoItem* item);
+
     QTableView* m_tableView;
-    QStandardItemModel* m_tableModel;
+    VideoTableModel* m_tableModel;  // 显示值直接取自 m_videoItems
     ColumnManager m_columnManager;
-    QList<TableColumns> m_currentColumnsOrder;
     QVector<VideoItem*> m_videoItems;
+    QHash<quint64, int> m_rowById;  // 行ID → 当前行号
     ProgressBarDelegate* m_progressDelegate;
-
-    // 路径记忆
-    QString m_lastVideoPath;
-    QString m_lastAudioPath;
-    QString m_lastOutputPath;
-    QString m_lastTitleFolderPath;
+    ColumnProber* m_prober = nullptr;  // 按需补全时长/大小等耗时列
+    VideoFilterProxy* m_proxy = nullptr;  // 视图显示的筛选/排序层
+    quint64 m_revision = 0;
 };
 
 #endif // TABLEMANAGER_H
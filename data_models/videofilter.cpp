@@ -0,0 +1,258 @@
+#include "data_models/videofilter.h"
+#include "data_models/tablemanager.h"
+#include "data_models/videoitem.h"
+#include <algorithm>
+
+// ===================== 索引 =====================
+QSet<quint64> VideoIndex::trigramsOf(const QString& foldedText)
+{
+    // 三个 UTF-16 码元打包为一个 64 位键
+    QSet<quint64> trigrams;
+    for (qsizetype i = 0; i + 2 < foldedText.size(); ++i) {
+        trigrams.insert((quint64(foldedText[i].unicode()) << 32)
+                        | (quint64(foldedText[i + 1].unicode()) << 16)
+                        | quint64(foldedText[i + 2].unicode()));
+    }
+    return trigrams;
+}
+
+quint8 VideoIndex::stateOf(const VideoItem* item)
+{
+    if (item->hasError() || item->progress() < 0) return StateFailed;
+    if (item->progress() >= 100) return StateDone;
+    return StatePending;
+}
+
+void VideoIndex::insert(const VideoItem* item)
+{
+    const quint64 id = item->id();
+    Entry entry;
+    entry.title = item->title().toCaseFolded();
+    entry.upName = item->upName().toCaseFolded();
+    entry.upUid = item->upUid();
+    entry.series = item->series().toCaseFolded();
+    entry.state = stateOf(item);
+
+    for (quint64 trigram : trigramsOf(entry.title)) {
+        m_trigrams[trigram].insert(id);
+    }
+    if (!entry.upName.isEmpty()) m_byUpName[entry.upName].insert(id);
+    if (entry.upUid > 0) m_byUpUid[entry.upUid].insert(id);
+    if (!entry.series.isEmpty()) m_bySeries[entry.series].insert(id);
+
+    m_entries.insert(id, entry);
+}
+
+void VideoIndex::remove(quint64 id)
+{
+    auto it = m_entries.find(id);
+    if (it == m_entries.end()) return;
+
+    // 移除后清理空的倒排表，避免删除大量行后残留空集合
+    auto removeFrom = [id](auto& hash, const auto& key) {
+        auto posting = hash.find(key);
+        if (posting == hash.end()) return;
+        posting->remove(id);
+        if (posting->isEmpty()) hash.erase(posting);
+    };
+    for (quint64 trigram : trigramsOf(it->title)) {
+        removeFrom(m_trigrams, trigram);
+    }
+    removeFrom(m_byUpName, it->upName);
+    removeFrom(m_byUpUid, it->upUid);
+    removeFrom(m_bySeries, it->series);
+
+    m_entries.erase(it);
+}
+
+void VideoIndex::update(const VideoItem* item)
+{
+    auto it = m_entries.constFind(item->id());
+    if (it != m_entries.constEnd()
+        && it->title == item->title().toCaseFolded()
+        && it->upName == item->upName().toCaseFolded()
+        && it->upUid == item->upUid()
+        && it->series == item->series().toCaseFolded()) {
+        // 导出过程中绝大多数变化只是进度，只更新状态位
+        m_entries[item->id()].state = stateOf(item);
+        return;
+    }
+    remove(item->id());
+    insert(item);
+}
+
+void VideoIndex::clear()
+{
+    m_entries.clear();
+    m_trigrams.clear();
+    m_byUpName.clear();
+    m_byUpUid.clear();
+    m_bySeries.clear();
+}
+
+QSet<quint64> VideoIndex::matchTitle(const QString& text) const
+{
+    const QString folded = text.toCaseFolded();
+    QSet<quint64> result;
+
+    if (folded.size() < 3) {
+        for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+            if (it->title.contains(folded)) result.insert(it.key());
+        }
+        return result;
+    }
+
+    // 从最短的倒排表开始求交集，再逐条确认子串（三元组全部命中不代表连续出现）
+    QList<const QSet<quint64>*> postings;
+    for (quint64 trigram : trigramsOf(folded)) {
+        auto it = m_trigrams.constFind(trigram);
+        if (it == m_trigrams.constEnd()) return result;
+        postings.append(&*it);
+    }
+    std::sort(postings.begin(), postings.end(),
+              [](const QSet<quint64>* a, const QSet<quint64>* b) { return a->size() < b->size(); });
+
+    for (quint64 id : *postings.first()) {
+        bool inAll = true;
+        for (int i = 1; i < postings.size() && inAll; ++i) {
+            inAll = postings[i]->contains(id);
+        }
+        if (inAll && titleContains(id, folded)) result.insert(id);
+    }
+    return result;
+}
+
+bool VideoIndex::titleContains(quint64 id, const QString& foldedText) const
+{
+    auto it = m_entries.constFind(id);
+    return it != m_entries.constEnd() && it->title.contains(foldedText);
+}
+
+// ===================== 筛选代理 =====================
+VideoFilterProxy::VideoFilterProxy(TableManager* tableManager, QObject* parent)
+    : QSortFilterProxyModel(parent)
+    , m_tableManager(tableManager)
+{
+}
+
+void VideoFilterProxy::setFilter(const QString& query, quint8 stateMask)
+{
+    const QString text = query.trimmed();
+    m_stateMask = stateMask;
+    m_hasQuery = !text.isEmpty();
+    m_matched.clear();
+
+    if (m_hasQuery) {
+        m_queryField = QueryTitle;
+        m_queryText = text;
+        const struct { const char* prefix; QueryField field; } prefixes[] = {
+            {"up:", QueryUpName}, {"uid:", QueryUpUid}, {"series:", QuerySeries}
+        };
+        for (const auto& p : prefixes) {
+            if (text.startsWith(QLatin1String(p.prefix), Qt::CaseInsensitive)) {
+                m_queryField = p.field;
+                m_queryText = text.mid(int(qstrlen(p.prefix))).trimmed();
+                break;
+            }
+        }
+        m_queryText = m_queryText.toCaseFolded();
+
+        switch (m_queryField) {
+        case QueryTitle:  m_matched = m_index.matchTitle(m_queryText); break;
+        case QueryUpName: m_matched = m_index.matchUpName(m_queryText); break;
+        case QueryUpUid:  m_matched = m_index.matchUpUid(m_queryText.toLongLong()); break;
+        case QuerySeries: m_matched = m_index.matchSeries(m_queryText); break;
+        }
+    }
+
+    invalidateRowsFilter();
+}
+
+bool VideoFilterProxy::matchesQuery(const VideoItem* item) const
+{
+    switch (m_queryField) {
+    case QueryTitle:  return m_index.titleContains(item->id(), m_queryText);
+    case QueryUpName: return item->upName().toCaseFolded() == m_queryText;
+    case QueryUpUid:  return item->upUid() == m_queryText.toLongLong();
+    case QuerySeries: return item->series().toCaseFolded() == m_queryText;
+    }
+    return false;
+}
+
+// 行增删改时只处理这一行：更新索引，并重新判断它是否满足当前查询
+void VideoFilterProxy::itemAdded(const VideoItem* item)
+{
+    m_index.insert(item);
+    if (m_hasQuery && matchesQuery(item)) m_matched.insert(item->id());
+}
+
+void VideoFilterProxy::itemChanged(const VideoItem* item)
+{
+    m_index.update(item);
+    if (m_hasQuery) {
+        if (matchesQuery(item)) {
+            m_matched.insert(item->id());
+        } else {
+            m_matched.remove(item->id());
+        }
+    }
+}
+
+void VideoFilterProxy::itemRemoved(quint64 id)
+{
+    m_index.remove(id);
+    m_matched.remove(id);
+}
+
+void VideoFilterProxy::reset()
+{
+    m_index.clear();
+    m_matched.clear();
+}
+
+QVariant VideoFilterProxy::data(const QModelIndex& index, int role) const
+{
+    if (role == Qt::DisplayRole && index.isValid()
+        && index.column() == ColumnSchema::columnWith(DelegateRowNumber)) {
+        return index.row() + 1;
+    }
+    return QSortFilterProxyModel::data(index, role);
+}
+
+bool VideoFilterProxy::filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const
+{
+    Q_UNUSED(sourceParent);
+    if (!isFiltering()) return true;
+
+    const VideoItem* item = m_tableManager->videoItemAt(sourceRow);
+    if (!item) return false;
+    if (m_hasQuery && !m_matched.contains(item->id())) return false;
+    return (m_index.state(item->id()) & m_stateMask) != 0;
+}
+
+bool VideoFilterProxy::lessThan(const QModelIndex& left, const QModelIndex& right) const
+{
+    const VideoItem* a = m_tableManager->videoItemAt(left.row());
+    const VideoItem* b = m_tableManager->videoItemAt(right.row());
+    if (!a || !b) return left.row() < right.row();
+
+    switch (m_tableManager->columnTypeAt(left.column())) {
+    case COL_INDEX:          return left.row() < right.row();
+    case COL_VIDEO_TYPE:     return a->videoType() < b->videoType();
+    case COL_CREATE_TIME:    return a->createTime() < b->createTime();
+    case COL_DURATION:       return a->duration() < b->duration();
+    case COL_TOTAL_SIZE:     return a->totalSize() < b->totalSize();
+    case COL_QUALITY:        return a->qualityId() < b->qualityId();
+    case COL_PROGRESS:       return a->progress() < b->progress();
+    case COL_UP_UID:         return a->upUid() < b->upUid();
+    case COL_DANMAKU_UPDATE: return a->danmakuUpdate() < b->danmakuUpdate();
+    case COL_DANMAKU_COUNT:  return a->danmakuCount() < b->danmakuCount();
+    case COL_TITLE:          return a->title().localeAwareCompare(b->title()) < 0;
+    case COL_UP_NAME:        return a->upName().localeAwareCompare(b->upName()) < 0;
+    case COL_SERIES:         return a->series().localeAwareCompare(b->series()) < 0;
+    case COL_AV_NUMBER:      return a->avNumber() < b->avNumber();
+    case COL_VIDEO_FILE:     return a->videoPath() < b->videoPath();
+    case COL_AUDIO_FILE:     return a->audioPath() < b->audioPath();
+    default:                 return left.row() < right.row();
+    }
+}
@@ -0,0 +1,104 @@
+#ifndef VIDEOFILTER_H
+#define VIDEOFILTER_H
+
+#include <QHash>
+#include <QSet>
+#include <QSortFilterProxyModel>
+#include <QString>
+
+class TableManager;
+class VideoItem;
+
+// 项目状态（可按位组合作为筛选条件）
+enum VideoStateFlag : quint8 {
+    StatePending = 0x1,   // 未导出 / 进行中
+    StateFailed  = 0x2,
+    StateDone    = 0x4,
+    StateAll     = StatePending | StateFailed | StateDone
+};
+
+// 筛选用的增量索引，按行ID组织，增删改单行时只更新该行的条目
+// - 标题：三元组倒排索引（不区分大小写）
+// - UP主昵称 / UID / 系列：哈希索引（精确匹配）
+// - 状态：每行一个状态位
+class VideoIndex
+{
+public:
+    void insert(const VideoItem* item);
+    void remove(quint64 id);
+    void update(const VideoItem* item);
+    void clear();
+
+    // 标题包含 text 的行ID（查询串不足3个字符时逐条比较）
+    QSet<quint64> matchTitle(const QString& text) const;
+    QSet<quint64> matchUpName(const QString& name) const { return m_byUpName.value(name.toCaseFolded()); }
+    QSet<quint64> matchUpUid(qint64 uid) const { return m_byUpUid.value(uid); }
+    QSet<quint64> matchSeries(const QString& series) const { return m_bySeries.value(series.toCaseFolded()); }
+
+    quint8 state(quint64 id) const { return m_entries.value(id).state; }
+    // 单行是否满足标题条件（增量更新时使用，不查索引）
+    bool titleContains(quint64 id, const QString& foldedText) const;
+
+    static quint8 stateOf(const VideoItem* item);
+
+private:
+    struct Entry {
+        QString title;    // 已折叠大小写
+        QString upName;   // 已折叠大小写
+        qint64 upUid = 0;
+        QString series;   // 已折叠大小写
+        quint8 state = StatePending;
+    };
+
+    static QSet<quint64> trigramsOf(const QString& foldedText);
+
+    QHash<quint64, Entry> m_entries;
+    QHash<quint64, QSet<quint64>> m_trigrams;   // 三元组 → 行ID
+    QHash<QString, QSet<quint64>> m_byUpName;
+    QHash<qint64, QSet<quint64>> m_byUpUid;
+    QHash<QString, QSet<quint64>> m_bySeries;
+};
+
+// 表格的筛选/排序层：
+// 查询时由索引算出匹配的行ID集合，filterAcceptsRow 只做一次集合查找，不经过 QVariant；
+// 排序直接比较 VideoItem 的类型化字段
+class VideoFilterProxy : public QSortFilterProxyModel
+{
+    Q_OBJECT
+public:
+    explicit VideoFilterProxy(TableManager* tableManager, QObject* parent = nullptr);
+
+    // 查询语法：普通文本匹配标题子串；"up:昵称"、"uid:数字"、"series:系列名" 精确匹配对应字段
+    void setFilter(const QString& query, quint8 stateMask);
+    bool isFiltering() const { return m_hasQuery || m_stateMask != StateAll; }
+
+    VideoIndex& index() { return m_index; }
+
+    // TableManager 在行增删改时调用，保持索引与匹配集合同步
+    void itemAdded(const VideoItem* item);
+    void itemChanged(const VideoItem* item);
+    void itemRemoved(quint64 id);
+    void reset();
+
+    // 序号列显示行在视图中的位置（排序/筛选后仍连续），其余列取源模型的数据
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
+    bool lessThan(const QModelIndex& left, const QModelIndex& right) const override;
+
+private:
+    bool matchesQuery(const VideoItem* item) const;
+
+    TableManager* m_tableManager;
+    VideoIndex m_index;
+
+    enum QueryField { QueryTitle, QueryUpName, QueryUpUid, QuerySeries };
+    QueryField m_queryField = QueryTitle;
+    QString m_queryText;          // 已折叠大小写
+    bool m_hasQuery = false;
+    QSet<quint64> m_matched;      // 满足查询条件的行ID（不含状态条件）
+    quint8 m_stateMask = StateAll;
+};
+
+#endif // VIDEOFILTER_H
@@ -1,44 +1,225 @@
 #include "data_models//videoitem.h"
+#include "data_models/stringpool.h"
+#include "data_models/sessionsnapshot.h"
+#include "scanner/cacheentry.h"
+#include "managers/applog.h"
 #include <QCryptographicHash>
 #include <QFile>
 #include <QDateTime>
+#include <QtMath>
+#include <QAtomicInteger>
+#include <QDataStream>
+#include <QDir>
 
-// ===================== 构造函数 =====================
-VideoItem::VideoItem(int index, QObject *parent)
-    : QObject(parent), m_index(index)
+namespace {
+
+QAtomicInteger<quint64> nextId(1);
+
+const QString& emptyText()
+{
+    static const QString text = QStringLiteral("<空>");
+    return text;
+}
+
+QVariant textOrEmpty(const QString& text)
 {
-    m_data.resize(TOTAL_COLUMNS);
+    return text.isEmpty() ? emptyText() : text;
+}
+
+QString formatTime(qint64 msecsSinceEpoch)
+{
+    return QDateTime::fromMSecsSinceEpoch(msecsSinceEpoch).toString("yyyy-MM-dd hh:mm");
+}
 
-    // 初始化默认值
-    for (int i = 0; i < TOTAL_COLUMNS; ++i) {
-        m_data[i] = "<空>";
+// "<空>" 视为未设置
+QString plainText(const QVariant& value)
+{
+    const QString text = value.toString().trimmed();
+    return text == emptyText() ? QString() : text;
+}
+
+qint64 parseTime(const QVariant& value)
+{
+    if (value.userType() == QMetaType::QDateTime) {
+        return value.toDateTime().toMSecsSinceEpoch();
     }
+    bool ok = false;
+    const qint64 msecs = value.toLongLong(&ok);
+    if (ok) return msecs;
 
-    // 设置特殊列默认值
-    m_data[COL_INDEX] = index;
-    m_data[COL_PROGRESS] = 0; // 进度条初始0
+    const QString text = plainText(value);
+    QDateTime time = QDateTime::fromString(text, "yyyy-MM-dd hh:mm");
+    if (!time.isValid()) time = QDateTime::fromString(text, Qt::ISODate);
+    return time.isValid() ? time.toMSecsSinceEpoch() : 0;
+}
 
-    m_duration = 0; // 初始化为0
+// 接受秒数或 "hh:mm:ss" / "mm:ss"
+int parseDuration(const QVariant& value)
+{
+    bool ok = false;
+    const int seconds = value.toInt(&ok);
+    if (ok) return seconds;
+
+    int total = 0;
+    for (const QString& part : plainText(value).section(QChar(0xFF08), 0, 0).split(':')) {
+        total = total * 60 + part.toInt();
+    }
+    return total;
+}
+
+// 接受字节数或 "12.3 MB" 这类显示值
+qint64 parseSize(const QVariant& value)
+{
+    bool ok = false;
+    const qint64 bytes = value.toLongLong(&ok);
+    if (ok) return bytes;
+
+    const QString text = plainText(value).toUpper();
+    const double number = text.section(' ', 0, 0).toDouble();
+    if (text.endsWith("GB")) return qint64(number * 1073741824.0);
+    if (text.endsWith("MB")) return qint64(number * 1048576.0);
+    if (text.endsWith("KB")) return qint64(number * 1024.0);
+    return qint64(number);
+}
+
+// 接受 qn 代码或清晰度名称
+int parseQuality(const QVariant& value)
+{
+    bool ok = false;
+    const int qualityId = value.toInt(&ok);
+    if (ok) return qualityId;
+
+    const QString name = plainText(value);
+    for (int id : {6, 16, 32, 64, 74, 80, 112, 116, 120, 125, 126, 127}) {
+        if (CacheEntry::qualityName(id) == name) return id;
+    }
+    return 0;
+}
+
+} // namespace
+
+// ===================== 构造函数 =====================
+VideoItem::VideoItem(QObject *parent)
+    : QObject(parent), m_id(nextId.fetchAndAddRelaxed(1))
+{
 }
 
 // ===================== 数据访问函数 =====================
 QVariant VideoItem::data(TableColumns column) const {
-    if (column >= 0 && column < TOTAL_COLUMNS) {
-        return m_data[column];
+    switch (column) {
+    case COL_INDEX:
+        // 序号由表格按行位置计算
+        return QVariant();
+    case COL_VIDEO_TYPE:
+        return m_videoType == VideoTypeUnknown ? emptyText() : videoTypeName(m_videoType);
+    case COL_TITLE:
+        return textOrEmpty(m_title);
+    case COL_CREATE_TIME:
+        return m_createTime > 0 ? formatTime(m_createTime) : emptyText();
+    case COL_DURATION:
+        // 挽救模式下显示实际合并的时长
+        if (m_salvageDuration > 0.0) {
+            return formatDuration(qFloor(m_salvageDuration)) + "（已截取）";
+        }
+        return m_duration > 0 ? formatDuration(m_duration) : emptyText();
+    case COL_TOTAL_SIZE:
+        return m_totalSize > 0 ? formatSize(m_totalSize) : emptyText();
+    case COL_QUALITY:
+        return m_qualityId > 0 ? CacheEntry::qualityName(m_qualityId) : emptyText();
+    case COL_PROGRESS:
+        return m_progress;
+    case COL_VIDEO_FILE:
+        return m_videoName.isEmpty() ? emptyText() : videoPath();
+    case COL_AUDIO_FILE:
+        return m_audioName.isEmpty() ? emptyText() : audioPath();
+    case COL_UP_NAME:
+        return textOrEmpty(m_upName);
+    case COL_UP_UID:
+        return m_upUid > 0 ? QString::number(m_upUid) : emptyText();
+    case COL_SERIES:
+        return textOrEmpty(m_series);
+    case COL_AV_NUMBER:
+        return textOrEmpty(m_avNumber);
+    case COL_DANMAKU_UPDATE:
+        return m_danmakuUpdate > 0 ? formatTime(m_danmakuUpdate) : emptyText();
+    case COL_DANMAKU_COUNT:
+        return m_danmakuCount >= 0 ? QVariant(m_danmakuCount) : QVariant(emptyText());
+    default:
+        break;
     }
 
     // 添加详细错误日志
-    qCritical() << "VideoItem::data - 无效列索引:" << column
+    qCCritical(lcTable) << "VideoItem::data - 无效列索引:" << column
                 << "最大允许:" << (TOTAL_COLUMNS-1);
     return QVariant();
 }
 
 void VideoItem::setData(TableColumns column, const QVariant &value) {
-    if (column >= 0 && column < TOTAL_COLUMNS) {
-        m_data[column] = value;
-    } else {
-        qCritical() << "VideoItem::setData - 无效列索引:" << column
+    switch (column) {
+    case COL_INDEX:
+        break;
+    case COL_VIDEO_TYPE: {
+        bool ok = false;
+        const int type = value.toInt(&ok);
+        if (ok) {
+            m_videoType = VideoType(qBound(0, type, int(VideoTypeCourse)));
+        } else {
+            m_videoType = VideoTypeUnknown;
+            for (VideoType candidate : {VideoTypeNormal, VideoTypeBangumi, VideoTypeCourse}) {
+                if (videoTypeName(candidate) == plainText(value)) m_videoType = candidate;
+            }
+        }
+        break;
+    }
+    case COL_TITLE:
+        m_title = plainText(value);
+        break;
+    case COL_CREATE_TIME:
+        m_createTime = parseTime(value);
+        break;
+    case COL_DURATION:
+        m_duration = parseDuration(value);
+        break;
+    case COL_TOTAL_SIZE:
+        m_totalSize = parseSize(value);
+        break;
+    case COL_QUALITY:
+        setQualityId(parseQuality(value));
+        break;
+    case COL_PROGRESS:
+        setProgress(value.toInt());
+        break;
+    case COL_VIDEO_FILE:
+        setVideoPath(plainText(value));
+        break;
+    case COL_AUDIO_FILE:
+        setAudioPath(plainText(value));
+        break;
+    case COL_UP_NAME:
+        setUpName(plainText(value));
+        break;
+    case COL_UP_UID:
+        m_upUid = plainText(value).toLongLong();
+        break;
+    case COL_SERIES:
+        setSeries(plainText(value));
+        break;
+    case COL_AV_NUMBER:
+        m_avNumber = plainText(value);
+        break;
+    case COL_DANMAKU_UPDATE:
+        m_danmakuUpdate = parseTime(value);
+        break;
+    case COL_DANMAKU_COUNT: {
+        bool ok = false;
+        const int count = value.toInt(&ok);
+        m_danmakuCount = ok ? count : -1;
+        break;
+    }
+    default:
+        qCCritical(lcTable) << "VideoItem::setData - 无效列索引:" << column
                     << "值:" << value;
+        break;
     }
 }
 
@@ -52,30 +233,150 @@ void VideoItem::setProgress(int progress) {
 
     if (m_progress != progress) {
         m_progress = progress;
-        m_data[COL_PROGRESS] = progress;
         emit dataChanged();
         emit progressChanged(progress);
     }
 }
 
 void VideoItem::setTitle(const QString &title) {
-    m_data[COL_TITLE] = title;
+    m_title = title;
     emit dataChanged();
 }
 
-void VideoItem::setIndex(int index)
+void VideoItem::setUpName(const QString& name)
 {
-    m_index = index;
-    m_data[COL_INDEX] = index;
-    emit dataChanged();
+    m_upName = StringPool::intern(name);
+}
+
+void VideoItem::setSeries(const QString& series)
+{
+    m_series = StringPool::intern(series);
+}
+
+QStringList VideoItem::contentFiles() const
+{
+    if (!m_segmentFiles.isEmpty()) {
+        return m_segmentFiles;
+    }
+
+    QStringList files;
+    if (!m_videoName.isEmpty()) files << videoPath();
+    if (!m_audioName.isEmpty()) files << audioPath();
+    return files;
+}
+
+// ===================== 会话快照 =====================
+namespace {
+
+enum SnapshotFlag : quint8 {
+    SnapshotHasError = 0x1,
+    SnapshotProbed   = 0x2
+};
+
+} // namespace
+
+void VideoItem::writeSnapshot(QDataStream& out, SnapshotStringTable& strings) const
+{
+    quint8 flags = 0;
+    if (m_hasError) flags |= SnapshotHasError;
+    if (m_probed) flags |= SnapshotProbed;
+
+    out << m_title
+        << strings.id(m_videoDir) << m_videoName
+        << strings.id(m_audioDir) << m_audioName
+        << strings.id(m_upName) << strings.id(m_series) << m_avNumber
+        << m_upUid << m_createTime << m_totalSize << m_danmakuUpdate
+        << qint32(m_duration) << qint32(m_danmakuCount) << qint32(m_progress)
+        << m_qualityId << quint8(m_videoType) << flags << m_salvageDuration
+        << m_subtitleFiles << m_segmentFiles << m_fingerprint << m_sourceIssue;
+}
+
+bool VideoItem::readSnapshot(QDataStream& in, const QStringList& strings)
+{
+    quint32 videoDir = 0, audioDir = 0, upName = 0, series = 0;
+    qint32 duration = 0, danmakuCount = -1, progress = 0;
+    quint8 videoType = 0, flags = 0;
+
+    in >> m_title
+       >> videoDir >> m_videoName
+       >> audioDir >> m_audioName
+       >> upName >> series >> m_avNumber
+       >> m_upUid >> m_createTime >> m_totalSize >> m_danmakuUpdate
+       >> duration >> danmakuCount >> progress
+       >> m_qualityId >> videoType >> flags >> m_salvageDuration
+       >> m_subtitleFiles >> m_segmentFiles >> m_fingerprint >> m_sourceIssue;
+
+    const quint32 stringCount = quint32(strings.size());
+    if (in.status() != QDataStream::Ok || videoDir >= stringCount || audioDir >= stringCount
+        || upName >= stringCount || series >= stringCount) {
+        return false;
+    }
+
+    m_videoDir = strings[videoDir];
+    m_audioDir = strings[audioDir];
+    m_upName = strings[upName];
+    m_series = strings[series];
+    m_duration = duration;
+    m_danmakuCount = danmakuCount;
+    m_videoType = VideoType(qMin<quint8>(videoType, VideoTypeCourse));
+    m_hasError = flags & SnapshotHasError;
+    m_probed = flags & SnapshotProbed;
+    // 上次退出时仍在混流的项目视为未导出
+    m_progress = (progress > 0 && progress < 100) ? 0 : progress;
+    return true;
+}
+
+// ===================== 格式化 =====================
+QString VideoItem::formatDuration(int seconds)
+{
+    return QString("%1:%2:%3")
+        .arg(seconds / 3600, 2, 10, QChar('0'))
+        .arg((seconds / 60) % 60, 2, 10, QChar('0'))
+        .arg(seconds % 60, 2, 10, QChar('0'));
+}
+
+QString VideoItem::formatSize(qint64 bytes)
+{
+    return QString("%1 MB").arg(bytes / 1048576.0, 0, 'f', 1);
+}
+
+QString VideoItem::videoTypeName(VideoType type)
+{
+    switch (type) {
+    case VideoTypeNormal:  return "普通视频";
+    case VideoTypeBangumi: return "番剧";
+    case VideoTypeCourse:  return "课程";
+    default:               return QString();
+    }
+}
+
+// ===================== 路径存储 =====================
+QString VideoItem::joinPath(const QString& dir, const QString& name)
+{
+    if (name.isEmpty()) return QString();
+    return dir.isEmpty() ? name : dir + '/' + name;
+}
+
+void VideoItem::splitPath(const QString& path, QString& dir, QString& name)
+{
+    // 手动输入或 toNativeSeparators 得到的 Windows 路径先统一为 '/'，同一目录只驻留一份
+    const QString normalized = QDir::fromNativeSeparators(path);
+    const int slash = normalized.lastIndexOf('/');
+    if (slash <= 0) {
+        dir.clear();
+        name = normalized;
+        return;
+    }
+    dir = StringPool::intern(normalized.left(slash));
+    name = normalized.mid(slash + 1);
 }
 
 bool VideoItem::checkFilesExist() const
 {
-    QString videoPath = data(COL_VIDEO_FILE).toString();
-    QString audioPath = data(COL_AUDIO_FILE).toString();
+    QString videoPath = this->videoPath();
+    QString audioPath = this->audioPath();
 
-    qDebug() << "检查文件是否存在 - 视频:" << videoPath << "音频:" << audioPath;
+    qCDebug(lcTable) << "检查文件是否存在 - 视频:" << videoPath << "音频:" << audioPath;
 
     QFile videoFile(videoPath);
     QFile audioFile(audioPath);
@@ -85,7 +386,7 @@ bool VideoItem::checkFilesExist() const
     bool videoSizeValid = videoFile.size() > 0;
     bool audioSizeValid = audioFile.size() > 0;
 
-    qDebug() << "文件检查结果 - 视频存在:" << videoExists << "视频大小有效:" << videoSizeValid
+    qCDebug(lcTable) << "文件检查结果 - 视频存在:" << videoExists << "视频大小有效:" << videoSizeValid
              << "音频存在:" << audioExists << "音频大小有效:" << audioSizeValid;
 
     return videoExists && audioExists && videoSizeValid && audioSizeValid;
@@ -93,8 +394,8 @@ bool VideoItem::checkFilesExist() const
 
 QString VideoItem::generateDefaultTitle() const
 {
-    QString videoPath = data(COL_VIDEO_FILE).toString();
-    QString audioPath = data(COL_AUDIO_FILE).toString();
+    QString videoPath = this->videoPath();
+    QString audioPath = this->audioPath();
 
     // 计算MD5哈希值
     QCryptographicHash hash(QCryptographicHash::Md5);
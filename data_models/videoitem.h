@@ -2,25 +2,40 @@
 #define VIDEOITEM_H
 
 #include <QObject>
-#include <QVector>
 #include <QVariant>
+#include <QStringList>
 #include "tablecolumns.h"
 
+class QDataStream;
+class SnapshotStringTable;
+
+// 视频类型
+enum VideoType : quint8 {
+    VideoTypeUnknown,
+    VideoTypeNormal,    // 普通投稿
+    VideoTypeBangumi,   // 番剧/影视
+    VideoTypeCourse     // 课程
+};
+
 class VideoItem : public QObject
 {
     Q_OBJECT
 public:
-    explicit VideoItem(int index, QObject *parent = nullptr);
+    explicit VideoItem(QObject *parent = nullptr);
 
-    // 获取/设置数据
+    // 获取/设置数据（按列访问，供表格显示和兼容旧代码使用）
+    // data() 返回格式化后的显示值，未设置的列返回"<空>"；
+    // 序号列由所在行位置决定，不在项目中保存，data(COL_INDEX) 返回无效值；
+    // setData() 接受显示字符串或原始数值，解析后存入对应的类型化字段
     QVariant data(TableColumns column) const;
     void setData(TableColumns column, const QVariant &value);
 
+    // 行ID：创建时分配，进程内唯一且不随行号变化，删除行后不会复用
+    quint64 id() const { return m_id; }
+
     // 特殊属性处理
-    int index() const { return m_index; }
     void setProgress(int progress);
     void setTitle(const QString &title);
-    void setIndex(int index);
 
     bool checkFilesExist() const;
     QString generateDefaultTitle() const;
@@ -29,20 +44,119 @@ public:
     bool hasError() const { return m_hasError; }
     void setHasError(bool error) { m_hasError = error; }
 
+    // ===== 类型化字段 =====
+    const QString& title() const { return m_title; }
+
+    // 路径按 目录+文件名 存储，目录经过驻留，同一缓存目录下的文件共享目录字符串
+    QString videoPath() const { return joinPath(m_videoDir, m_videoName); }
+    void setVideoPath(const QString& path) { splitPath(path, m_videoDir, m_videoName); m_probed = false; }
+    QString audioPath() const { return joinPath(m_audioDir, m_audioName); }
+    void setAudioPath(const QString& path) { splitPath(path, m_audioDir, m_audioName); m_probed = false; }
+
+    const QString& upName() const { return m_upName; }
+    void setUpName(const QString& name);
+    qint64 upUid() const { return m_upUid; }
+    void setUpUid(qint64 uid) { m_upUid = uid; }
+    const QString& series() const { return m_series; }
+    void setSeries(const QString& series);
+    const QString& avNumber() const { return m_avNumber; }
+    void setAvNumber(const QString& avNumber) { m_avNumber = avNumber; }
+
+    // B站清晰度代码（qn），0 表示未知
+    int qualityId() const { return m_qualityId; }
+    void setQualityId(int qualityId) { m_qualityId = quint16(qualityId); }
+    VideoType videoType() const { return m_videoType; }
+    void setVideoType(VideoType type) { m_videoType = type; }
+
+    // 创建时间（自纪元起的毫秒数），0 表示未知
+    qint64 createTime() const { return m_createTime; }
+    void setCreateTime(qint64 msecsSinceEpoch) { m_createTime = msecsSinceEpoch; }
+    // 文件总大小（字节），0 表示未知
+    qint64 totalSize() const { return m_totalSize; }
+    void setTotalSize(qint64 bytes) { m_totalSize = bytes; }
+
+    // 时长（秒），0 表示未知
     int duration() const { return m_duration; }
     void setDuration(int duration) { m_duration = duration; }
 
+    qint64 danmakuUpdate() const { return m_danmakuUpdate; }
+    void setDanmakuUpdate(qint64 msecsSinceEpoch) { m_danmakuUpdate = msecsSinceEpoch; }
+    // 弹幕数，-1 表示未知
+    int danmakuCount() const { return m_danmakuCount; }
+    void setDanmakuCount(int count) { m_danmakuCount = count; }
+
+    // 时长/大小/清晰度/弹幕数需要读文件才能得到，由 ColumnProber 按需补全；更换文件后需重新探测
+    bool isProbed() const { return m_probed; }
+    void markProbed() { m_probed = true; emit dataChanged(); }
+
+    // 同目录下的CC字幕JSON文件（混流时转换为文本字幕轨道）
+    QStringList subtitleFiles() const { return m_subtitleFiles; }
+    void setSubtitleFiles(const QStringList& files) { m_subtitleFiles = files; }
+
+    // 旧版缓存的分段FLV（按段号排序），非空时代替视频/音频文件拼接输出
+    QStringList segmentFiles() const { return m_segmentFiles; }
+    void setSegmentFiles(const QStringList& files) { m_segmentFiles = files; m_probed = false; }
+
+    // 抽样内容指纹（用于去重），未计算时为空
+    QString fingerprint() const { return m_fingerprint; }
+    void setFingerprint(const QString& fingerprint) { m_fingerprint = fingerprint; }
+    // 参与指纹计算的文件：分段FLV或视频+音频
+    QStringList contentFiles() const;
+
+    // 合并前完整性检查发现的问题（为空表示正常）
+    QString sourceIssue() const { return m_sourceIssue; }
+    void setSourceIssue(const QString& issue) { m_sourceIssue = issue; emit dataChanged(); }
+
+    // 挽救模式下实际合并的时长（秒），0 表示合并完整文件
+    double salvageDuration() const { return m_salvageDuration; }
+    void setSalvageDuration(double seconds) { m_salvageDuration = seconds; }
+
+    // 会话快照读写（见 SessionSnapshot）：目录/UP主/系列写为字符串表序号
+    // 读取时 strings 中的字符串应已驻留；进行中的进度视为中断，恢复为未导出
+    void writeSnapshot(QDataStream& out, SnapshotStringTable& strings) const;
+    bool readSnapshot(QDataStream& in, const QStringList& strings);
+
+    // 格式化工具（表格显示用）
+    static QString formatDuration(int seconds);
+    static QString formatSize(qint64 bytes);
+    static QString videoTypeName(VideoType type);
+
 signals:
     void dataChanged();
     void progressChanged(int progress); // 添加进度改变信号
 
 private:
+    static QString joinPath(const QString& dir, const QString& name);
+    static void splitPath(const QString& path, QString& dir, QString& name);
+
+    const quint64 m_id;
+    QString m_title;
+    QString m_videoDir;     // 驻留
+    QString m_videoName;
+    QString m_audioDir;     // 驻留
+    QString m_audioName;
+    QString m_upName;       // 驻留
+    QString m_series;       // 驻留
+    QString m_avNumber;
+
+    qint64 m_upUid = 0;
+    qint64 m_createTime = 0;
+    qint64 m_totalSize = 0;
+    qint64 m_danmakuUpdate = 0;
+
     int m_duration = 0;
-    int m_index; // 行序号
-    QVector<QVariant> m_data; // 存储所有列的数据
+    int m_danmakuCount = -1;
     int m_progress = 0; // 添加进度成员变量
-
+    quint16 m_qualityId = 0;
+    VideoType m_videoType = VideoTypeUnknown;
     bool m_hasError = false; // 添加错误状态跟踪
+    bool m_probed = false;
+
+    QStringList m_subtitleFiles;
+    QStringList m_segmentFiles;
+    QString m_sourceIssue;
+    double m_salvageDuration = 0.0;
+    QString m_fingerprint;
 };
 
 #endif // VIDEOITEM_H
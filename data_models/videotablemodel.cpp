@@ -0,0 +1,94 @@
+#include "data_models/videotablemodel.h"
+#include "data_models/tablemanager.h"
+#include "data_models/videoitem.h"
+
+namespace {
+
+constexpr TableColumns kRowNumberColumn = ColumnSchema::columnWith(DelegateRowNumber);
+constexpr TableColumns kProgressColumn = ColumnSchema::columnWith(DelegateProgress);
+
+} // namespace
+
+VideoTableModel::VideoTableModel(TableManager* tableManager, QObject* parent)
+    : QAbstractTableModel(parent)
+    , m_tableManager(tableManager)
+{
+}
+
+int VideoTableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_tableManager->rowCount();
+}
+
+int VideoTableModel::columnCount(const QModelIndex& parent) const
+{
+    // 模型始终包含全部列（列号即 TableColumns），可选列的显示/隐藏只在视图层处理
+    return parent.isValid() ? 0 : TOTAL_COLUMNS;
+}
+
+QVariant VideoTableModel::data(const QModelIndex& index, int role) const
+{
+    const VideoItem* item = index.isValid() ? m_tableManager->videoItemAt(index.row()) : nullptr;
+    if (!item) return QVariant();
+
+    const TableColumns column = m_tableManager->columnTypeAt(index.column());
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+        // 序号由行位置决定，不在项目中保存
+        if (column == kRowNumberColumn) return index.row() + 1;
+        return item->data(column);
+    case Qt::TextAlignmentRole:
+        return int(Qt::AlignCenter);
+    case Qt::ToolTipRole:
+        // 进度列提示完整性检查发现的问题
+        if (column == kProgressColumn && !item->sourceIssue().isEmpty()) return item->sourceIssue();
+        break;
+    default:
+        break;
+    }
+    return QVariant();
+}
+
+QVariant VideoTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole && ColumnSchema::isValid(TableColumns(section))) {
+        return QString::fromUtf8(kColumnTable[section].name);
+    }
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+Qt::ItemFlags VideoTableModel::flags(const QModelIndex& index) const
+{
+    Qt::ItemFlags itemFlags = QAbstractTableModel::flags(index);
+    if (index.isValid() && ColumnSchema::isEditable(m_tableManager->columnTypeAt(index.column()))) {
+        itemFlags |= Qt::ItemIsEditable;
+    }
+    return itemFlags;
+}
+
+bool VideoTableModel::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+    if (!index.isValid() || role != Qt::EditRole) return false;
+
+    const TableColumns column = m_tableManager->columnTypeAt(index.column());
+    if (column == TOTAL_COLUMNS || column == kRowNumberColumn) return false;
+
+    // 编辑器提交的未修改显示值（含"<空>"）不是用户编辑，忽略
+    const VideoItem* item = m_tableManager->videoItemAt(index.row());
+    if (!item || item->data(column) == value) return false;
+
+    m_tableManager->updateVideoItem(index.row(), column, value);
+    return true;
+}
+
+void VideoTableModel::beginAppendRows(int count)
+{
+    const int first = rowCount();
+    beginInsertRows(QModelIndex(), first, first + count - 1);
+}
+
+void VideoTableModel::rowsChanged(int first, int last)
+{
+    emit dataChanged(index(first, 0), index(last, TOTAL_COLUMNS - 1));
+}
@@ -0,0 +1,38 @@
+#ifndef VIDEOTABLEMODEL_H
+#define VIDEOTABLEMODEL_H
+
+#include <QAbstractTableModel>
+
+class TableManager;
+
+// 表格的源模型：不保存单元格，显示值在取数据时由 VideoItem 的类型化字段格式化
+// （视图只请求可见单元格）。行数据归 TableManager 所有，增删行前后由其调用 begin*/end*
+class VideoTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    explicit VideoTableModel(TableManager* tableManager, QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+    // 写入对应的 VideoItem 字段（经 TableManager::updateVideoItem）
+    bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+
+    // TableManager 修改行列表前后调用
+    void beginAppendRows(int count);
+    void endAppendRows() { endInsertRows(); }
+    void beginRemoveItemRows(int first, int count) { beginRemoveRows(QModelIndex(), first, first + count - 1); }
+    void endRemoveItemRows() { endRemoveRows(); }
+    void beginResetItems() { beginResetModel(); }
+    void endResetItems() { endResetModel(); }
+    // 行数据变化：通知筛选/排序层和视图重新取数据
+    void rowsChanged(int first, int last);
+
+private:
+    TableManager* m_tableManager;
+};
+
+#endif // VIDEOTABLEMODEL_H
@@ -0,0 +1,20 @@
+#ifndef MERGEOPTIONS_H
+#define MERGEOPTIONS_H
+
+#include <QString>
+
+// 混流选项（由设置对话框修改，MainWindow 持久化并下发给 MergeManager）
+struct MergeOptions {
+    bool embedMetadata = true;   // 混流时写入标题/UP主/UID/av号等元数据
+    bool embedCover = true;      // 混流时嵌入文件夹中的封面图片
+    bool fastStart = false;      // moov 置于 mdat 之前（网页播放器需要）
+    bool muxDanmaku = false;     // 将弹幕XML转换为ASS并作为字幕轨道写入（仅MKV）
+    bool muxCcSubtitles = true;  // 将CC字幕JSON转换为SRT/WebVTT并作为字幕轨道写入
+    bool verifyOutput = true;    // 混流后校验输出文件结构与时长
+    bool checkSources = true;    // 入队前检查输入文件是否下载完整
+    bool salvageTruncated = false; // 下载不完整时只合并音视频都完整的前段
+    bool skipExported = true;    // 跳过输出目录清单中已导出过的相同内容
+    QString format = "mp4";      // 输出容器：mp4 / mkv
+};
+
+#endif // MERGEOPTIONS_H
@@ -1,5 +1,7 @@
 #include "progressbardelegate.h"
 #include <QApplication>
+#include <QPainter>
+#include <QPixmapCache>
 #include <QStyle>
 
 ProgressBarDelegate::ProgressBarDelegate(QObject *parent)
@@ -11,23 +13,63 @@ void ProgressBarDelegate::paint(QPainter *painter, const QStyleOptionViewItem &o
                                 const QModelIndex &index) const
 {
     if (index.data().canConvert<int>()) {
-        int progress = index.data().toInt();
+        const int progress = qBound(-1, index.data().toInt(), 100);
+        const QSize size = option.rect.size();
+        if (size.isEmpty()) return;
 
-        QStyleOptionProgressBar progressBarOption;
-        progressBarOption.rect = option.rect;
-        progressBarOption.minimum = 0;
-        progressBarOption.maximum = 100;
-        progressBarOption.progress = progress;
-        progressBarOption.text = QString::number(progress) + "%";
-        progressBarOption.textVisible = true;
+        // 同一进度、尺寸、状态、缩放比例的进度条只绘制一次，之后直接贴图
+        const qreal dpr = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+        const bool enabled = option.state & QStyle::State_Enabled;
+        const QString key = QStringLiteral("memoria_progress_%1_%2x%3_%4_%5_%6")
+                                .arg(progress).arg(size.width()).arg(size.height())
+                                .arg(enabled).arg(dpr).arg(option.palette.cacheKey());
 
-        QApplication::style()->drawControl(QStyle::CE_ProgressBar,
-                                           &progressBarOption, painter);
+        QPixmap pixmap;
+        if (!QPixmapCache::find(key, &pixmap)) {
+            pixmap = renderProgressBar(progress, option, dpr);
+            QPixmapCache::insert(key, pixmap);
+        }
+        painter->drawPixmap(option.rect.topLeft(), pixmap);
     } else {
         QStyledItemDelegate::paint(painter, option, index);
     }
 }
 
+QPixmap ProgressBarDelegate::renderProgressBar(int progress, const QStyleOptionViewItem &option, qreal dpr)
+{
+    QPixmap pixmap(option.rect.size() * dpr);
+    pixmap.setDevicePixelRatio(dpr);
+    pixmap.fill(Qt::transparent);
+
+    QStyleOptionProgressBar progressBarOption;
+    progressBarOption.rect = QRect(QPoint(0, 0), option.rect.size());
+    progressBarOption.state = option.state & QStyle::State_Enabled;
+    progressBarOption.direction = option.direction;
+    progressBarOption.palette = option.palette;
+    progressBarOption.fontMetrics = option.fontMetrics;
+    progressBarOption.minimum = 0;
+    progressBarOption.maximum = 100;
+    progressBarOption.textVisible = true;
+
+    // -1 表示失败，100 表示完成，用不同颜色的满格进度条区分
+    if (progress < 0) {
+        progressBarOption.progress = 100;
+        progressBarOption.text = "失败";
+        progressBarOption.palette.setColor(QPalette::Highlight, QColor(0xD9, 0x53, 0x4F));
+    } else if (progress >= 100) {
+        progressBarOption.progress = 100;
+        progressBarOption.text = "完成";
+        progressBarOption.palette.setColor(QPalette::Highlight, QColor(0x5C, 0xB8, 0x5C));
+    } else {
+        progressBarOption.progress = progress;
+        progressBarOption.text = QString::number(progress) + "%";
+    }
+
+    QPainter painter(&pixmap);
+    QApplication::style()->drawControl(QStyle::CE_ProgressBar, &progressBarOption, &painter);
+    return pixmap;
+}
+
 QSize ProgressBarDelegate::sizeHint(const QStyleOptionViewItem &option,
                                     const QModelIndex &index) const
 {
@@ -3,6 +3,7 @@
 
 #include <QStyledItemDelegate>
 #include <QProgressBar>
+#include <QPixmap>
 
 class ProgressBarDelegate : public QStyledItemDelegate
 {
@@ -14,6 +15,10 @@ public:
                const QModelIndex &index) const override;
     QSize sizeHint(const QStyleOptionViewItem &option,
                    const QModelIndex &index) const override;
+
+private:
+    // 绘制一次进度条到像素图，结果由 QPixmapCache 缓存
+    static QPixmap renderProgressBar(int progress, const QStyleOptionViewItem &option, qreal dpr);
 };
 
 #endif // PROGRESSBARDELEGATE_H
@@ -0,0 +1,13 @@
+#ifndef RENDITIONPOLICY_H
+#define RENDITIONPOLICY_H
+
+// 同一分P/剧集缓存了多个清晰度时保留哪一个
+enum RenditionPolicy {
+    RenditionHighestQuality,  // 清晰度最高
+    RenditionPreferredCodec,  // 优先指定编码，其次清晰度最高
+    RenditionSmallestSize,    // 文件最小
+    RenditionKeepAll          // 全部导入
+};
+
+
+#endif // RENDITIONPOLICY_H
@@ -1,14 +1,14 @@
 #include "dialogs/setting_dialog.h"
 #include "dialogs/ui_setting_dialog.h"
 #include <QCheckBox>
+#include <QComboBox>
 #include <QVBoxLayout>
-#include <QDebug>
 #include <QMessageBox>
-#include <QSettings>
 #include "del_setting_dialog.h"
 #include "dialogs/export_setting_dialog.h"
 #include "mainwindow.h"
 #include "data_models/tablemanager.h" // 添加包含
+#include "managers/applog.h"
 
 // ===================== 构造函数/析构函数 =====================
 Setting_Dialog::Setting_Dialog(TableManager* tableManager, QWidget *parent)
@@ -20,8 +20,8 @@ Setting_Dialog::Setting_Dialog(TableManager* tableManager, QWidget *parent)
     , m_deleteDialogShowing(false)
     , m_settingsChanged(false)
 {
-    qDebug() << "------------------ Settings Dialog Initialized ------------------";
-    qDebug() << "Parent Widget:" << parent->objectName();
+    qCDebug(lcApp) << "------------------ Settings Dialog Initialized ------------------";
+    qCDebug(lcApp) << "Parent Widget:" << parent->objectName();
 
     ui->setupUi(this);
 
@@ -40,11 +40,63 @@ Setting_Dialog::Setting_Dialog(TableManager* tableManager, QWidget *parent)
         m_currentExportMode = m_mainWindow->getExportMode();
         m_currentExportRememberChoice = m_mainWindow->getExportRememberChoice();
         updateExportModeDisplay();
+
+        m_currentMergeOptions = m_mainWindow->getMergeOptions();
+        m_currentRenditionPolicy = m_mainWindow->getRenditionPolicy();
+        m_currentPreferredCodecId = m_mainWindow->getPreferredCodecId();
+        m_currentDedupOnImport = m_mainWindow->getDedupOnImport();
+    }
+
+    // 初始化混流选项
+    ui->embedMetadataCheckBox->setChecked(m_currentMergeOptions.embedMetadata);
+    ui->embedCoverCheckBox->setChecked(m_currentMergeOptions.embedCover);
+    ui->fastStartCheckBox->setChecked(m_currentMergeOptions.fastStart);
+    ui->muxDanmakuCheckBox->setChecked(m_currentMergeOptions.muxDanmaku);
+    ui->muxCcSubtitlesCheckBox->setChecked(m_currentMergeOptions.muxCcSubtitles);
+    ui->verifyOutputCheckBox->setChecked(m_currentMergeOptions.verifyOutput);
+    ui->checkSourcesCheckBox->setChecked(m_currentMergeOptions.checkSources);
+    ui->salvageTruncatedCheckBox->setChecked(m_currentMergeOptions.salvageTruncated);
+    ui->salvageTruncatedCheckBox->setEnabled(m_currentMergeOptions.checkSources);
+    ui->formatComboBox->setCurrentText(m_currentMergeOptions.format);
+    // MP4只能写mov_text，弹幕的\move/\pos会丢失：弹幕轨道只对MKV开放
+    ui->muxDanmakuCheckBox->setEnabled(m_currentMergeOptions.format == "mkv");
+    ui->muxDanmakuCheckBox->setToolTip("MP4字幕轨道不支持ASS定位与滚动，弹幕只能混流到MKV");
+    connect(ui->embedMetadataCheckBox, &QCheckBox::checkStateChanged, this, &Setting_Dialog::onSettingChanged);
+    connect(ui->embedCoverCheckBox, &QCheckBox::checkStateChanged, this, &Setting_Dialog::onSettingChanged);
+    connect(ui->fastStartCheckBox, &QCheckBox::checkStateChanged, this, &Setting_Dialog::onSettingChanged);
+    connect(ui->muxDanmakuCheckBox, &QCheckBox::checkStateChanged, this, &Setting_Dialog::onSettingChanged);
+    connect(ui->muxCcSubtitlesCheckBox, &QCheckBox::checkStateChanged, this, &Setting_Dialog::onSettingChanged);
+    connect(ui->verifyOutputCheckBox, &QCheckBox::checkStateChanged, this, &Setting_Dialog::onSettingChanged);
+    connect(ui->checkSourcesCheckBox, &QCheckBox::checkStateChanged, this, &Setting_Dialog::onSettingChanged);
+    connect(ui->checkSourcesCheckBox, &QCheckBox::toggled, ui->salvageTruncatedCheckBox, &QCheckBox::setEnabled);
+    connect(ui->salvageTruncatedCheckBox, &QCheckBox::checkStateChanged, this, &Setting_Dialog::onSettingChanged);
+    connect(ui->formatComboBox, &QComboBox::currentTextChanged, this, [this](const QString& format) {
+        ui->muxDanmakuCheckBox->setEnabled(format == "mkv");
+        onSettingChanged();
+    });
+
+    // 初始化导入选项（编码下拉框顺序：AVC、HEVC、AV1）
+    static const int codecIds[] = {7, 12, 13};
+    ui->renditionPolicyComboBox->setCurrentIndex(m_currentRenditionPolicy);
+    for (int i = 0; i < 3; ++i) {
+        if (codecIds[i] == m_currentPreferredCodecId) ui->preferredCodecComboBox->setCurrentIndex(i);
     }
+    ui->preferredCodecComboBox->setEnabled(m_currentRenditionPolicy == RenditionPreferredCodec);
+    connect(ui->renditionPolicyComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) {
+        ui->preferredCodecComboBox->setEnabled(index == RenditionPreferredCodec);
+        onSettingChanged();
+    });
+    connect(ui->preferredCodecComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &Setting_Dialog::onSettingChanged);
+    ui->dedupOnImportCheckBox->setChecked(m_currentDedupOnImport);
+    ui->skipExportedCheckBox->setChecked(m_currentMergeOptions.skipExported);
+    connect(ui->dedupOnImportCheckBox, &QCheckBox::checkStateChanged, this, &Setting_Dialog::onSettingChanged);
+    connect(ui->skipExportedCheckBox, &QCheckBox::checkStateChanged, this, &Setting_Dialog::onSettingChanged);
 
     // 设置选项卡标题
     ui->tabWidget->setTabText(0, "列设置");
     ui->tabWidget->setTabText(1, "其他设置");
+    ui->tabWidget->setTabText(2, "导入设置");
 
     // 确保 columnsContainer 有垂直布局
     QVBoxLayout* columnsLayout = new QVBoxLayout(ui->columnsContainer);
@@ -97,37 +149,55 @@ Setting_Dialog::Setting_Dialog(TableManager* tableManager, QWidget *parent)
     // 初始禁用应用按钮
     ui->ApplyButton->setEnabled(false);
 
-    qDebug() << "Delete Mode:" << m_currentDeleteMode;
-    qDebug() << "Export Mode:" << m_currentExportMode;
-    qDebug() << "------------------ Initial Settings Loaded ------------------";
+    qCDebug(lcApp) << "Delete Mode:" << m_currentDeleteMode;
+    qCDebug(lcApp) << "Export Mode:" << m_currentExportMode;
+    qCDebug(lcApp) << "------------------ Initial Settings Loaded ------------------";
 }
 
 Setting_Dialog::~Setting_Dialog()
 {
-    qDebug() << "~Setting_Dialog()" << this;
-    qDebug() << "Deleting UI";
+    qCDebug(lcApp) << "~Setting_Dialog()" << this;
+    qCDebug(lcApp) << "Deleting UI";
     delete ui;
-    qDebug() << "UI deleted";
+    qCDebug(lcApp) << "UI deleted";
 }
 
 // ===================== 应用设置函数 =====================
 void Setting_Dialog::applySettings()
 {
-    // 通过 TableManager 获取 ColumnManager
-    ColumnManager* columnManager = &m_tableManager->columnManager();
-
-    // 应用列设置
+    // 应用列设置（直接切换表格列的显示/隐藏，"应用"按钮也立即生效）
     for (QCheckBox* checkBox : ui->columnsContainer->findChildren<QCheckBox*>()) {
         if (checkBox != m_selectAllCheckBox && checkBox->property("column").isValid()) {
             TableColumns column = static_cast<TableColumns>(checkBox->property("column").toInt());
-            columnManager->setColumnVisibility(column, checkBox->isChecked());
+            m_tableManager->setColumnVisible(column, checkBox->isChecked());
         }
     }
 
+    // 应用混流选项
+    m_currentMergeOptions.embedMetadata = ui->embedMetadataCheckBox->isChecked();
+    m_currentMergeOptions.embedCover = ui->embedCoverCheckBox->isChecked();
+    m_currentMergeOptions.fastStart = ui->fastStartCheckBox->isChecked();
+    m_currentMergeOptions.muxDanmaku = ui->muxDanmakuCheckBox->isChecked();
+    m_currentMergeOptions.muxCcSubtitles = ui->muxCcSubtitlesCheckBox->isChecked();
+    m_currentMergeOptions.verifyOutput = ui->verifyOutputCheckBox->isChecked();
+    m_currentMergeOptions.checkSources = ui->checkSourcesCheckBox->isChecked();
+    m_currentMergeOptions.salvageTruncated = ui->salvageTruncatedCheckBox->isChecked();
+    m_currentMergeOptions.format = ui->formatComboBox->currentText();
+
+    // 应用导入选项
+    static const int codecIds[] = {7, 12, 13};
+    m_currentRenditionPolicy = static_cast<RenditionPolicy>(ui->renditionPolicyComboBox->currentIndex());
+    m_currentPreferredCodecId = codecIds[qBound(0, ui->preferredCodecComboBox->currentIndex(), 2)];
+    m_currentDedupOnImport = ui->dedupOnImportCheckBox->isChecked();
+    m_currentMergeOptions.skipExported = ui->skipExportedCheckBox->isChecked();
+
     // 应用删除模式设置
     if (m_mainWindow) {
         m_mainWindow->setDeleteSettings(m_currentDeleteMode, m_currentRememberChoice);
         m_mainWindow->setExportSettings(m_currentExportMode, m_currentExportRememberChoice);
+        m_mainWindow->setMergeOptions(m_currentMergeOptions);
+        m_mainWindow->setImportSettings(m_currentRenditionPolicy, m_currentPreferredCodecId,
+                                        m_currentDedupOnImport);
     }
 
     m_mainWindow->setDeleteSettings(m_currentDeleteMode, m_currentRememberChoice);
@@ -150,7 +220,7 @@ void Setting_Dialog::updateDeleteModeDisplay()
     }
 
     ui->del_state_line->setText(stateText);
-    qDebug() << "updateDeleteModeDisplay:" << stateText;
+    qCDebug(lcApp) << "updateDeleteModeDisplay:" << stateText;
 }
 
 void Setting_Dialog::handleStateSettingButtonClicked()
@@ -183,10 +253,10 @@ void Setting_Dialog::handleStateSettingButtonClicked()
 // ===================== 全选功能相关函数 =====================
 void Setting_Dialog::onSelectAllStateChanged(int state)
 {
-    qDebug() << "------------------ SelectAll State Changed ------------------";
-    qDebug() << "New state:" << state;
+    qCDebug(lcApp) << "------------------ SelectAll State Changed ------------------";
+    qCDebug(lcApp) << "New state:" << state;
     // 在 onSelectAllStateChanged 槽函数开头添加
-    qDebug() << "onSelectAllStateChanged triggered. State:" << state;
+    qCDebug(lcApp) << "onSelectAllStateChanged triggered. State:" << state;
 
     // 阻止递归调用
     static bool inProgress = false;
@@ -216,14 +286,12 @@ void Setting_Dialog::onSelectAllStateChanged(int state)
 
     // 在循环中添加列状态检查
     for (QCheckBox* checkBox : columnCheckBoxes) {
-        qDebug() << "Column:" << checkBox->text()
+        qCDebug(lcApp) << "Column:" << checkBox->text()
         << "Current state:" << checkBox->isChecked()
         << "New state should be:" << (state == Qt::Checked);
     }
 
     m_settingsChanged = true;
-    QSettings settings;
-
 }
 
 void Setting_Dialog::onOptionCheckboxChanged()
@@ -275,7 +343,7 @@ void Setting_Dialog::updateExportModeDisplay()
     }
 
     ui->exp_stase_line->setText(stateText);
-    qDebug() << "updateExportModeDisplay:" << stateText;
+    qCDebug(lcApp) << "updateExportModeDisplay:" << stateText;
 }
 
 void Setting_Dialog::on_statesetting_Button_2_clicked()
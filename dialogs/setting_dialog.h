@@ -6,6 +6,8 @@
 #include <QCheckBox>
 #include "delegates/deletemode.h"
 #include "delegates/exportmode.h"
+#include "delegates/mergeoptions.h"
+#include "delegates/renditionpolicy.h"
 #include "data_models/tablemanager.h" // 添加包含
 
 class MainWindow;
@@ -47,6 +49,14 @@ private:
     ExportMode m_currentExportMode;
     bool m_currentExportRememberChoice;
 
+    // 混流选项
+    MergeOptions m_currentMergeOptions;
+
+    // 导入选项
+    RenditionPolicy m_currentRenditionPolicy = RenditionHighestQuality;
+    int m_currentPreferredCodecId = 7;
+    bool m_currentDedupOnImport = true;
+
     MainWindow* m_mainWindow;
 
     // 添加对话框显示控制成员变量
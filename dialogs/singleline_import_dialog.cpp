@@ -1,10 +1,16 @@
 #include "dialogs/singleline_import_dialog.h"
 #include "dialogs/ui_singleline_import_dialog.h"
-#include <QSettings>
+#include "managers/settingsstore.h"
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
 #include <QProcess>
+#include <QHash>
+#include <QMutex>
+#include <QPointer>
+#include <QThreadPool>
 
 // ===================== 构造函数/析构函数 =====================
 singleline_import_dialog::singleline_import_dialog(QWidget *parent)
@@ -13,6 +19,10 @@ singleline_import_dialog::singleline_import_dialog(QWidget *parent)
 {
     ui->setupUi(this);
 
+    // 手动输入路径后同样在后台检查
+    connect(ui->VideoAddline, &QLineEdit::editingFinished, this, [this]() { startValidation(true); });
+    connect(ui->AudioAddline, &QLineEdit::editingFinished, this, [this]() { startValidation(false); });
+
     // 加载路径设置
     loadPathSettings();
 }
@@ -23,15 +33,134 @@ singleline_import_dialog::~singleline_import_dialog()
 }
 
 // ===================== 验证M4S文件 =====================
-bool singleline_import_dialog::validateM4sFile(const QString& filePath, bool isVideo)
+namespace {
+
+// 进程内的检查结果缓存：重新选择已检查过的文件时直接给出结果
+// 键包含文件大小和修改时间，文件被替换或改写后自动失效
+struct ValidationCacheEntry {
+    bool ok = false;
+    QString message;
+};
+
+QMutex validationCacheMutex;
+QHash<QString, ValidationCacheEntry> validationCache;
+
+// 文件不存在时返回空键，不查也不写缓存
+QString validationCacheKey(const QString& filePath, bool isVideo)
+{
+    const QFileInfo info(filePath);
+    if (!info.isFile()) return QString();
+    return QStringLiteral("%1|%2|%3|%4")
+        .arg(isVideo ? QStringLiteral("v") : QStringLiteral("a"))
+        .arg(info.size())
+        .arg(info.lastModified().toMSecsSinceEpoch())
+        .arg(info.absoluteFilePath());
+}
+
+} // namespace
+
+void singleline_import_dialog::startValidation(bool isVideo)
+{
+    FieldValidation& f = field(isVideo);
+    const QString filePath = (isVideo ? ui->VideoAddline : ui->AudioAddline)->text();
+    const quint64 generation = ++f.generation;
+
+    if (filePath.isEmpty()) {
+        f.state = FieldEmpty;
+        f.message.clear();
+        updateStatusLabel(isVideo);
+        return;
+    }
+
+    // 命中缓存不经过线程池
+    const QString cacheKey = validationCacheKey(filePath, isVideo);
+    if (!cacheKey.isEmpty()) {
+        QMutexLocker locker(&validationCacheMutex);
+        auto cached = validationCache.constFind(cacheKey);
+        if (cached != validationCache.constEnd()) {
+            const ValidationCacheEntry entry = *cached;
+            locker.unlock();
+            applyValidation(isVideo, generation, entry.ok, entry.message);
+            return;
+        }
+    }
+
+    f.state = FieldPending;
+    f.message.clear();
+    updateStatusLabel(isVideo);
+
+    QPointer<singleline_import_dialog> self(this);
+    QThreadPool::globalInstance()->start([self, filePath, isVideo, generation, cacheKey]() {
+        QString message;
+        bool cacheable = true;
+        const bool ok = checkM4sFile(filePath, isVideo, message, cacheable);
+        // 检查期间文件可能被改写：键以检查前的大小和修改时间为准，不一致时不缓存
+        if (cacheable && !cacheKey.isEmpty() && cacheKey == validationCacheKey(filePath, isVideo)) {
+            QMutexLocker locker(&validationCacheMutex);
+            validationCache.insert(cacheKey, {ok, message});
+        }
+        if (!self) return;
+        QMetaObject::invokeMethod(self.data(), [self, isVideo, generation, ok, message]() {
+            if (self) self->applyValidation(isVideo, generation, ok, message);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void singleline_import_dialog::applyValidation(bool isVideo, quint64 generation, bool ok, const QString& message)
+{
+    FieldValidation& f = field(isVideo);
+    if (generation != f.generation) return;
+
+    f.state = ok ? FieldOk : FieldFailed;
+    f.message = message;
+    updateStatusLabel(isVideo);
+
+    // 对话框已取消时不再确认
+    if (m_acceptWhenReady && isVisible()
+        && m_videoField.state != FieldPending && m_audioField.state != FieldPending) {
+        m_acceptWhenReady = false;
+        ui->OkButton->setEnabled(true);
+        on_OkButton_clicked();
+    }
+}
+
+void singleline_import_dialog::updateStatusLabel(bool isVideo)
 {
+    const FieldValidation& f = field(isVideo);
+    QLabel* label = isVideo ? ui->VideoStatusLabel : ui->AudioStatusLabel;
+
+    switch (f.state) {
+    case FieldEmpty:
+        label->clear();
+        label->setStyleSheet(QString());
+        break;
+    case FieldPending:
+        label->setText("检查中…");
+        label->setStyleSheet("color: gray;");
+        break;
+    case FieldOk:
+        label->setText("正常");
+        label->setStyleSheet("color: green;");
+        break;
+    case FieldFailed:
+        label->setText("失败");
+        label->setStyleSheet("color: red;");
+        break;
+    }
+    label->setToolTip(f.message);
+}
+
+// 在工作线程中执行，不能弹出对话框；失败原因通过 message 返回
+bool singleline_import_dialog::checkM4sFile(const QString& filePath, bool isVideo, QString& message, bool& cacheable)
+{
+    cacheable = true;
     if (!QFile::exists(filePath)) {
-        QMessageBox::warning(this, "错误", "文件不存在");
+        message = "文件不存在";
         return false;
     }
 
     if (!filePath.toLower().endsWith(".m4s")) {
-        QMessageBox::warning(this, "错误", "请选择.m4s文件");
+        message = "请选择.m4s文件";
         return false;
     }
 
@@ -54,14 +183,17 @@ bool singleline_import_dialog::validateM4sFile(const QString& filePath, bool isV
 
     if (!ffmpeg.waitForStarted()) {
         // FFmpeg不可用，跳过详细验证
-        QMessageBox::warning(this, "警告", "无法启动FFmpeg进行文件验证，将跳过详细检查");
+        message = "无法启动FFmpeg进行文件验证，已跳过详细检查";
+        cacheable = false;
         return true;
     }
 
     // 等待进程完成，设置超时时间
     if (!ffmpeg.waitForFinished(5000)) { // 5秒超时
-        QMessageBox::warning(this, "警告", "FFmpeg验证超时，将跳过详细检查");
+        message = "FFmpeg验证超时，已跳过详细检查";
         ffmpeg.kill(); // 终止进程
+        ffmpeg.waitForFinished();
+        cacheable = false;
         return true;
     }
 
@@ -70,12 +202,12 @@ bool singleline_import_dialog::validateM4sFile(const QString& filePath, bool isV
     // 检查中文和英文的输出
     if (isVideo) {
         if (!output.contains("Video:") && !output.contains("视频:")) {
-            QMessageBox::warning(this, "错误", "选择的文件不包含视频流");
+            message = "选择的文件不包含视频流";
             return false;
         }
     } else {
         if (!output.contains("Audio:") && !output.contains("音频:")) {
-            QMessageBox::warning(this, "错误", "选择的文件不包含音频流");
+            message = "选择的文件不包含音频流";
             return false;
         }
     }
@@ -116,12 +248,13 @@ void singleline_import_dialog::on_VideoInputButton_clicked()
         tr("M4S文件 (*.m4s);;所有文件 (*)")
         );
 
-    if (!videoPath.isEmpty() && validateM4sFile(videoPath, true)) {
+    if (!videoPath.isEmpty()) {
         ui->VideoAddline->setText(videoPath);
+        startValidation(true);
 
         // 更新共享的文件对话框路径
         m_lastFileDialogPath = QFileInfo(videoPath).absolutePath();
-        savePathSettings();
+        saveFileDialogPath();
     }
 }
 
@@ -135,12 +268,13 @@ void singleline_import_dialog::on_AudioInputButton_clicked()
         tr("M4S文件 (*.m4s);;所有文件 (*)")
         );
 
-    if (!audioPath.isEmpty() && validateM4sFile(audioPath, false)) {
+    if (!audioPath.isEmpty()) {
         ui->AudioAddline->setText(audioPath);
+        startValidation(false);
 
         // 更新共享的文件对话框路径
         m_lastFileDialogPath = QFileInfo(audioPath).absolutePath();
-        savePathSettings();
+        saveFileDialogPath();
     }
 }
 
@@ -178,16 +312,18 @@ void singleline_import_dialog::on_TitlefolderButton_clicked()
         QString videoPath = dir.filePath("video.m4s");
         if (QFile::exists(videoPath)) {
             ui->VideoAddline->setText(videoPath);
+            startValidation(true);
         }
 
         QString audioPath = dir.filePath("audio.m4s");
         if (QFile::exists(audioPath)) {
             ui->AudioAddline->setText(audioPath);
+            startValidation(false);
         }
 
         // 更新路径记忆 - 存储实际选择的文件夹路径
         m_lastTitleFolderPath = folderPath;
-        savePathSettings();
+        SettingsStore::instance().setValue(SettingKeys::LastTitleFolderPath, m_lastTitleFolderPath);
 
         // 同时更新文件对话框路径，以便视频和音频浏览按钮使用
         m_lastFileDialogPath = folderPath;
@@ -211,14 +347,24 @@ void singleline_import_dialog::on_OkButton_clicked()
         return;
     }
 
-    // 验证文件是否存在
-    if (!videoPath.isEmpty() && !QFile::exists(videoPath)) {
-        QMessageBox::warning(this, "错误", "视频文件不存在");
+    // 路径被修改但尚未检查（例如直接点击确定）时补一次检查
+    if (!videoPath.isEmpty() && m_videoField.state == FieldEmpty) startValidation(true);
+    if (!audioPath.isEmpty() && m_audioField.state == FieldEmpty) startValidation(false);
+
+    // 检查结果未到达时不阻塞界面，等结果到达后自动重新确认
+    if (m_videoField.state == FieldPending || m_audioField.state == FieldPending) {
+        m_acceptWhenReady = true;
+        ui->OkButton->setEnabled(false);
+        return;
+    }
+
+    if (!videoPath.isEmpty() && m_videoField.state == FieldFailed) {
+        QMessageBox::warning(this, "错误", "视频文件：" + m_videoField.message);
         return;
     }
 
-    if (!audioPath.isEmpty() && !QFile::exists(audioPath)) {
-        QMessageBox::warning(this, "错误", "音频文件不存在");
+    if (!audioPath.isEmpty() && m_audioField.state == FieldFailed) {
+        QMessageBox::warning(this, "错误", "音频文件：" + m_audioField.message);
         return;
     }
 
@@ -227,7 +373,7 @@ void singleline_import_dialog::on_OkButton_clicked()
         QDir dir(m_lastFileDialogPath);
         if (dir.cdUp()) {
             m_lastFileDialogPath = dir.path();
-            savePathSettings();
+            saveFileDialogPath();
         }
     }
 
@@ -244,14 +390,13 @@ void singleline_import_dialog::on_CancelButton_clicked()
 
 void singleline_import_dialog::loadPathSettings()
 {
-    QSettings settings;
-    m_lastFileDialogPath = settings.value("Last/FileDialogPath", QDir::homePath()).toString();
-    m_lastTitleFolderPath = settings.value("Last/TitleFolderPath", QDir::homePath()).toString();
+    const SettingsStore& settings = SettingsStore::instance();
+    m_lastFileDialogPath = settings.value(SettingKeys::LastFileDialogPath, QDir::homePath());
+    m_lastTitleFolderPath = settings.value(SettingKeys::LastTitleFolderPath, QDir::homePath());
 }
 
-void singleline_import_dialog::savePathSettings()
+// 只写文件对话框路径，不用本对话框打开时的旧值覆盖其他窗口记住的标题文件夹路径
+void singleline_import_dialog::saveFileDialogPath()
 {
-    QSettings settings;
-    settings.setValue("Last/FileDialogPath", m_lastFileDialogPath);
-    settings.setValue("Last/TitleFolderPath", m_lastTitleFolderPath);
+    SettingsStore::instance().setValue(SettingKeys::LastFileDialogPath, m_lastFileDialogPath);
 }
@@ -28,14 +28,33 @@ private slots:
 private:
     Ui::singleline_import_dialog *ui;
 
-    bool validateM4sFile(const QString& filePath, bool isVideo);
+    // 文件字段的检查状态
+    enum FieldState { FieldEmpty, FieldPending, FieldOk, FieldFailed };
+
+    struct FieldValidation {
+        FieldState state = FieldEmpty;
+        QString message;      // 失败原因或提示
+        quint64 generation = 0; // 字段内容变化后丢弃旧的检查结果
+    };
+
+    // M4S文件检查在线程池中执行（可能读网络共享上的文件或启动FFmpeg），结果回到GUI线程
+    void startValidation(bool isVideo);
+    void applyValidation(bool isVideo, quint64 generation, bool ok, const QString& message);
+    void updateStatusLabel(bool isVideo);
+    FieldValidation& field(bool isVideo) { return isVideo ? m_videoField : m_audioField; }
+    // cacheable 为 false 表示结果取决于当时环境（FFmpeg无法启动或超时），不应缓存
+    static bool checkM4sFile(const QString& filePath, bool isVideo, QString& message, bool& cacheable);
     bool validateTitleFolder(const QString& folderPath);
 
+    FieldValidation m_videoField;
+    FieldValidation m_audioField;
+    bool m_acceptWhenReady = false; // 点击确定时仍有检查未完成，结果到达后再确认
+
     QString m_lastFileDialogPath;  // 共享的文件对话框路径
     QString m_lastTitleFolderPath;
 
     void loadPathSettings();
-    void savePathSettings();
+    void saveFileDialogPath();
 };
 
 #endif // SINGLELINE_IMPORT_DIALOG_H
@@ -1,25 +1,84 @@
 #include "mainwindow.h"
+#include "managers/applog.h"
 
 #include <QApplication>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <cstdio>
+
+namespace {
+
+// 启动耗时基准（--startup-bench）：记录主窗口构造完成、首次绘制与会话恢复完成的时间，输出后退出
+class StartupBenchmark : public QObject
+{
+public:
+    StartupBenchmark(const QElapsedTimer& clock, MainWindow* window)
+        : m_clock(clock), m_window(window) {}
+
+    void start()
+    {
+        m_constructedMs = m_clock.elapsed();
+        qApp->installEventFilter(this);
+        connect(m_window, &MainWindow::sessionRestored, this, [this]() {
+            std::fprintf(stdout, "startup: MainWindow constructed %lld ms, first paint %lld ms, "
+                                 "session restored %lld ms\n",
+                         m_constructedMs, m_firstPaintMs, m_clock.elapsed());
+            std::fflush(stdout);
+            QTimer::singleShot(0, qApp, &QCoreApplication::quit);
+        });
+    }
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override
+    {
+        // 会话恢复在首次绘制之后进行，等 sessionRestored 再退出
+        if (event->type() == QEvent::Paint && m_firstPaintMs < 0 && watched->isWidgetType()
+            && static_cast<QWidget*>(watched)->window() == m_window) {
+            m_firstPaintMs = m_clock.elapsed();
+            qApp->removeEventFilter(this);
+        }
+        return QObject::eventFilter(watched, event);
+    }
+
+private:
+    const QElapsedTimer& m_clock;
+    MainWindow* m_window;
+    qint64 m_constructedMs = 0;
+    qint64 m_firstPaintMs = -1;
+};
+
+} // namespace
 
 int main(int argc, char *argv[])
 {
-    qDebug() << "------------------ Application Startup ------------------";
-    qDebug() << "Qt Version:" << QT_VERSION_STR;
-    qDebug() << "Platform:" << QSysInfo::prettyProductName();
+    QElapsedTimer startupClock;
+    startupClock.start();
+
+    // 最先安装，启动阶段的消息也进入最近事件记录
+    AppLog::install();
+
+    qCDebug(lcApp) << "------------------ Application Startup ------------------";
+    qCDebug(lcApp) << "Qt Version:" << QT_VERSION_STR;
+    qCDebug(lcApp) << "Platform:" << QSysInfo::prettyProductName();
 
     QApplication a(argc, argv);
-    qDebug() << "QApplication Initialized";
+    qCDebug(lcApp) << "QApplication Initialized";
 
     // 配置应用程序信息（必须在创建QSettings对象前设置）
     QCoreApplication::setOrganizationName("FuliTech");
     QCoreApplication::setApplicationName("Memoria");
 
     MainWindow w;
-    qDebug() << "MainWindow instance created."; // 调试点2：确认窗口实例创建
+    qCDebug(lcApp) << "MainWindow instance created."; // 调试点2：确认窗口实例创建
+
+    // 启动基准模式：cmake --build . --target startup_bench
+    StartupBenchmark benchmark(startupClock, &w);
+    if (QCoreApplication::arguments().contains("--startup-bench")) {
+        benchmark.start();
+    }
 
     w.show();
-    qDebug() << "MainWindow shown."; // 调试点3：确认show()被调用
+    qCDebug(lcApp) << "MainWindow shown."; // 调试点3：确认show()被调用
 
     return a.exec();
 }
@@ -3,92 +3,211 @@
 #include "ui_mainwindow.h"
 #include <QHeaderView>
 #include <QProgressBar>
-#include <QSettings>
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QProcess>
 #include <QStandardPaths>
 #include <QTimer>
+#include <QPointer>
+#include <QFileInfo>
+#include <QHash>
+#include <QSet>
+#include <QThreadPool>
 #include "dialogs/setting_dialog.h"
 #include "dialogs/singleline_import_dialog.h"
 #include "dialogs/del_setting_dialog.h"
 #include "dialogs/export_setting_dialog.h"
 #include "data_models/tablemanager.h"
+#include "data_models/videofilter.h"
+#include "data_models/sessionsnapshot.h"
+#include "managers/settingsstore.h"
 #include "managers/mergemanager.h" // 确保cpp文件也包含这个头文件
+#include "scanner/cachescanner.h"
+#include "media/contentfingerprint.h"
+#include "managers/applog.h"
 
 // ===================== 构造函数/析构函数 =====================
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
-    , m_mergeManager(nullptr)
 {
-    qDebug() << "------------------ MainWindow Initialization ------------------";
-    qDebug() << "Qt Version:" << QT_VERSION_STR;
-    qDebug() << "Platform:" << QSysInfo::prettyProductName();
+    qCDebug(lcApp) << "------------------ MainWindow Initialization ------------------";
+    qCDebug(lcApp) << "Qt Version:" << QT_VERSION_STR;
+    qCDebug(lcApp) << "Platform:" << QSysInfo::prettyProductName();
 
     // ===================== UI初始化 =====================
-    qDebug() << "UI setup start";
+    qCDebug(lcApp) << "UI setup start";
     ui->setupUi(this);
-    qDebug() << "UI setup done. MaintableView:" << ui->MaintableView;
+    qCDebug(lcApp) << "UI setup done. MaintableView:" << ui->MaintableView;
     this->setWindowTitle("Memoria V2.4.0");
 
     // 检查关键UI组件
     if (!ui->MaintableView) {
-        qCritical() << "MaintableView is null!";
+        qCCritical(lcApp) << "MaintableView is null!";
         return;
     }
 
     // ===================== 核心组件初始化 =====================
     // 初始化TableManager
-    qDebug() << "Creating TableManager";
+    qCDebug(lcApp) << "Creating TableManager";
     m_tableManager = new TableManager(ui->MaintableView, this);
-    qDebug() << "Before table view initialization";
+    qCDebug(lcApp) << "Before table view initialization";
     m_tableManager->initTableView();  // 初始化表格视图
-    qDebug() << "Table view initialized";
+    qCDebug(lcApp) << "Table view initialized";
 
     // 初始化路径设置
     m_tableManager->initPathMemory();
     ui->outputAdd_Edit->setText(m_tableManager->lastOutputPath());
 
-    // 初始化进度条委托
-    m_progressDelegate = new QProgressBar(this);
-    m_progressDelegate->setRange(0, 100);
-    m_progressDelegate->setTextVisible(false);
-
     // ===================== 设置加载 =====================
-    QSettings settings;
+    loadSettings();
+
+    // ===================== 上下文菜单设置 =====================
+    // 菜单管理器与合并管理器在首次使用时才创建，见 contextMenuManager() / mergeManager()
+    setupContextMenu();
+
+    // ===================== 信号连接 =====================
+    // 表格筛选：输入即筛选，状态下拉框依次为 全部/待处理/失败/已完成
+    auto applyFilter = [this]() {
+        static const quint8 stateMasks[] = {StateAll, StatePending, StateFailed, StateDone};
+        const int stateIndex = qBound(0, ui->stateFilterComboBox->currentIndex(), 3);
+        m_tableManager->setFilter(ui->searchEdit->text(), stateMasks[stateIndex]);
+    };
+    connect(ui->searchEdit, &QLineEdit::textChanged, this, applyFilter);
+    connect(ui->stateFilterComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, applyFilter);
+
+    // 上次退出时的表格在首次绘制之后恢复，不推迟窗口出现
+    ui->MaintableView->viewport()->installEventFilter(this);
+
+    // ===================== 初始化状态检查 =====================
+    qCDebug(lcApp) << "All connections established";
+    qCDebug(lcApp) << "------------------ Initial State Check ------------------";
+    qCDebug(lcApp) << "Video Items Count:" << m_tableManager->rowCount();
+    qCDebug(lcApp) << "MainWindow constructor completed";
+}
+
+MainWindow::~MainWindow()
+{
+    qCDebug(lcApp) << "~MainWindow() start";
+    saveSessionSnapshot(false);
+    qCDebug(lcApp) << "Deleting UI";
+    delete ui;
+    qCDebug(lcApp) << "UI deleted";
+    qCDebug(lcApp) << "~MainWindow() end";  // 移除对videoItems和tableModel的操作
+}
+
+
+// ===================== 设置加载 =====================
+// 启动时主窗口设置从 SettingsStore 读取（内存中，只在首次访问时读一次磁盘）
+void MainWindow::loadSettings()
+{
+    const SettingsStore& settings = SettingsStore::instance();
 
     // 加载删除设置
-    m_rememberDeleteChoice = settings.value("delete/remember", false).toBool();
-    m_deleteMode = static_cast<DeleteMode>(settings.value("delete/mode", DeleteFirst).toInt());
+    m_rememberDeleteChoice = settings.value(SettingKeys::DeleteRemember, false);
+    m_deleteMode = static_cast<DeleteMode>(settings.value(SettingKeys::DeleteMode, int(DeleteFirst)));
 
     // 加载导出设置
-    m_rememberExportChoice = settings.value("RememberExportChoice", false).toBool();
-    m_exportMode = static_cast<ExportMode>(settings.value("ExportMode", ExportSingle).toInt());
+    m_rememberExportChoice = settings.value(SettingKeys::RememberExportChoice, false);
+    m_exportMode = static_cast<ExportMode>(settings.value(SettingKeys::ExportMode, int(ExportSingle)));
     updateExportStatusDisplay();
 
-    // ===================== 管理器初始化 =====================
-    // 初始化上下文菜单管理器
-    qDebug() << "Creating ContextMenuManager";
-    m_contextMenuManager = new ContextMenuManager(this, ui->MaintableView, this);
-    qDebug() << "ContextMenuManager created:" << (m_contextMenuManager != nullptr);
+    // 加载混流选项
+    m_mergeOptions.embedMetadata = settings.value(SettingKeys::MergeEmbedMetadata, true);
+    m_mergeOptions.embedCover = settings.value(SettingKeys::MergeEmbedCover, true);
+    m_mergeOptions.fastStart = settings.value(SettingKeys::MergeFastStart, false);
+    m_mergeOptions.muxDanmaku = settings.value(SettingKeys::MergeMuxDanmaku, false);
+    m_mergeOptions.muxCcSubtitles = settings.value(SettingKeys::MergeMuxCcSubtitles, true);
+    m_mergeOptions.verifyOutput = settings.value(SettingKeys::MergeVerifyOutput, true);
+    m_mergeOptions.checkSources = settings.value(SettingKeys::MergeCheckSources, true);
+    m_mergeOptions.salvageTruncated = settings.value(SettingKeys::MergeSalvageTruncated, false);
+    m_mergeOptions.skipExported = settings.value(SettingKeys::MergeSkipExported, true);
+    m_mergeOptions.format = settings.value(SettingKeys::MergeFormat, QStringLiteral("mp4"));
+    if (m_mergeOptions.format != "mp4" && m_mergeOptions.format != "mkv") {
+        m_mergeOptions.format = "mp4";
+    }
 
-    // 初始化合并管理器
-    qDebug() << "Creating MergeManager";
-    m_mergeManager = new MergeManager(m_tableManager, this);
-    qDebug() << "MergeManager created at" << m_mergeManager;
+    // 加载导入选项
+    m_renditionPolicy = static_cast<RenditionPolicy>(
+        qBound<int>(RenditionHighestQuality, settings.value(SettingKeys::ImportRenditionPolicy, int(RenditionHighestQuality)), RenditionKeepAll));
+    m_preferredCodecId = settings.value(SettingKeys::ImportPreferredCodec, 7);
+    m_dedupOnImport = settings.value(SettingKeys::ImportDedup, true);
+}
 
-    // ===================== 上下文菜单设置 =====================
-    qDebug() << "Setting up context menu";
-    setupContextMenu();
-    qDebug() << "Context menu setup complete";
+// ===================== 会话快照 =====================
+bool MainWindow::eventFilter(QObject* watched, QEvent* event)
+{
+    // 表格首次绘制后再恢复会话，恢复大量行不影响窗口首次出现的时间
+    if (event->type() == QEvent::Paint && watched == ui->MaintableView->viewport()) {
+        ui->MaintableView->viewport()->removeEventFilter(this);
+        QTimer::singleShot(0, this, &MainWindow::restoreSessionSnapshot);
+    }
+    return QMainWindow::eventFilter(watched, event);
+}
 
-    // ===================== 信号连接 =====================
-    // 连接上下文菜单管理器的信号
+void MainWindow::restoreSessionSnapshot()
+{
+    m_snapshotPool.setMaxThreadCount(1);
+    SessionSnapshot::restore(*m_tableManager, SessionSnapshot::defaultPath());
+    m_snapshotRevision = m_tableManager->revision();
+    m_sessionRestored = true;
+
+    // 每分钟检查一次，表格有变化才保存
+    m_snapshotTimer = new QTimer(this);
+    m_snapshotTimer->setInterval(60 * 1000);
+    connect(m_snapshotTimer, &QTimer::timeout, this, [this]() { saveSessionSnapshot(true); });
+    m_snapshotTimer->start();
+
+    emit sessionRestored();
+}
+
+void MainWindow::saveSessionSnapshot(bool async)
+{
+    if (!m_sessionRestored || !m_tableManager || m_tableManager->revision() == m_snapshotRevision) {
+        return;
+    }
+
+    // 序列化需要读取 VideoItem，在GUI线程完成；写文件放到后台
+    const QByteArray data = SessionSnapshot::serialize(*m_tableManager);
+    const QString path = SessionSnapshot::defaultPath();
+    m_snapshotRevision = m_tableManager->revision();
+
+    if (async) {
+        m_snapshotPool.start([path, data]() { SessionSnapshot::writeFile(path, data); });
+    } else {
+        // 等待尚未完成的后台写入，避免旧快照覆盖新快照
+        m_snapshotPool.waitForDone();
+        SessionSnapshot::writeFile(path, data);
+    }
+}
+
+
+// ===================== 初始化函数组 =====================
+void MainWindow::setupContextMenu()
+{
+    qCDebug(lcApp) << "=== Entering setupContextMenu ===";
+
+    // 菜单在第一次右键时才创建
+    ui->MaintableView->setContextMenuPolicy(Qt::CustomContextMenu);
+    connect(ui->MaintableView, &QTableView::customContextMenuRequested, this, [this](const QPoint& pos) {
+        contextMenuManager()->showContextMenu(pos);
+    });
+
+    qCDebug(lcApp) << "=== Context menu setup complete ===";
+}
+
+ContextMenuManager* MainWindow::contextMenuManager()
+{
+    if (m_contextMenuManager) {
+        return m_contextMenuManager;
+    }
+
+    qCDebug(lcApp) << "Creating ContextMenuManager";
+    m_contextMenuManager = new ContextMenuManager(this, ui->MaintableView, this);
+
+    // 连接上下文菜单管理器的信号（来自菜单的导入、预览和导出请求）
     connect(m_contextMenuManager, &ContextMenuManager::importSourceRequested,
             this, &MainWindow::on_wholsoueflie_importButton_clicked);
-
-    // 新增的信号连接（来自ContextMenuManager的预览和导出请求）
     connect(m_contextMenuManager, &ContextMenuManager::previewRequested,
             this, &MainWindow::previewItemAtRow);
     connect(m_contextMenuManager, &ContextMenuManager::exportSingleRequested,
@@ -97,17 +216,19 @@ MainWindow::MainWindow(QWidget *parent)
             this, [this]() { performExportOperation(ExportSelected); });
     connect(m_contextMenuManager, &ContextMenuManager::exportAllRequested,
             this, [this]() { performExportOperation(ExportAll); });
-    // 连接上下文菜单的信号
-    // 连接上下文菜单的信号
-    if (m_contextMenuManager) {
-        connect(m_contextMenuManager, &ContextMenuManager::importSourceRequested,
-                this, &MainWindow::on_wholsoueflie_importButton_clicked);
+    return m_contextMenuManager;
+}
 
-        // 新增预览连接
-        connect(m_contextMenuManager, &ContextMenuManager::previewRequested,
-                this, &MainWindow::previewItemAtRow);
+MergeManager* MainWindow::mergeManager()
+{
+    if (m_mergeManager) {
+        return m_mergeManager;
     }
 
+    qCDebug(lcApp) << "Creating MergeManager";
+    m_mergeManager = new MergeManager(m_tableManager, this);
+    m_mergeManager->setOptions(m_mergeOptions);
+
     // 连接合并管理器的信号
     connect(m_mergeManager, &MergeManager::errorOccurred, this, [this](const QString& error) {
         QMessageBox::critical(this, "错误", error);
@@ -116,36 +237,7 @@ MainWindow::MainWindow(QWidget *parent)
             ui->Total_progressBar, &QProgressBar::setValue);
     connect(m_mergeManager, &MergeManager::mergingFinished,
             this, &MainWindow::showMergeResultMessage);
-
-    // ===================== 初始化状态检查 =====================
-    qDebug() << "All connections established";
-    qDebug() << "------------------ Initial State Check ------------------";
-    qDebug() << "Video Items Count:" << m_tableManager->rowCount();
-    qDebug() << "Merge Manager Status:" << (m_mergeManager ? "Initialized" : "Not Initialized");
-    qDebug() << "MainWindow constructor completed";
-}
-
-MainWindow::~MainWindow()
-{
-    qDebug() << "~MainWindow() start";
-    qDebug() << "Deleting UI";
-    delete ui;
-    qDebug() << "UI deleted";
-    qDebug() << "~MainWindow() end";  // 移除对videoItems和tableModel的操作
-}
-
-
-// ===================== 初始化函数组 =====================
-void MainWindow::setupContextMenu()
-{
-    qDebug() << "=== Entering setupContextMenu ===";
-    qDebug() << "ContextMenuManager valid:" << (m_contextMenuManager != nullptr);
-
-    if (m_contextMenuManager) {
-        m_contextMenuManager->setupContextMenu();
-    }
-
-    qDebug() << "=== Context menu setup complete ===";
+    return m_mergeManager;
 }
 
 
@@ -165,40 +257,181 @@ void MainWindow::on_singleline_importButton_clicked()
 
 void MainWindow::on_wholsoueflie_importButton_clicked()
 {
-    // TODO: 实现整个缓存源文件导入功能
+    QString rootPath = QFileDialog::getExistingDirectory(
+        this,
+        tr("选择缓存目录"),
+        m_tableManager->lastTitleFolderPath(),
+        QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks
+        );
+    if (rootPath.isEmpty()) {
+        return;
+    }
+
+    m_tableManager->setLastTitleFolderPath(rootPath);
+    ui->wholsoueflie_importButton->setEnabled(false);
+
+    // 去重需要已有行的指纹：已有行的文件列表一并交给后台，只为大小相同的内容计算指纹
+    QList<QPointer<VideoItem>> existingItems;
+    QList<QStringList> existingFiles;
+    QList<bool> existingHashed;
+    if (m_dedupOnImport) {
+        for (VideoItem* item : m_tableManager->videoItems()) {
+            existingItems.append(item);
+            existingFiles.append(item->contentFiles());
+            existingHashed.append(!item->fingerprint().isEmpty());
+        }
+    }
+
+    // 扫描可能涉及上千个目录，在线程池中进行
+    QPointer<MainWindow> self(this);
+    const RenditionPolicy policy = m_renditionPolicy;
+    const int preferredCodecId = m_preferredCodecId;
+    const bool dedup = m_dedupOnImport;
+    QThreadPool::globalInstance()->start([self, rootPath, policy, preferredCodecId, dedup,
+                                          existingItems, existingFiles, existingHashed]() {
+        CacheScanner scanner;
+        scanner.setRenditionPolicy(policy, preferredCodecId);
+        QList<CacheEntry> entries = scanner.scan(rootPath);
+        const QString layout = scanner.detectedLayout();
+        const int skipped = scanner.skippedRenditions();
+
+        // 指纹包含文件大小，大小不同的内容不可能重复：
+        // 先按总大小分组（只取文件信息），只有大小与其他项相同的才读文件计算指纹
+        QStringList existingFingerprints;  // 与 existingItems 对应，无需计算的为空
+        if (dedup) {
+            auto totalSize = [](const QStringList& paths) {
+                qint64 size = 0;
+                for (const QString& path : paths) size += QFileInfo(path).size();
+                return size;
+            };
+            auto entryFiles = [](const CacheEntry& entry) {
+                return entry.segmentFiles.isEmpty() ? QStringList{entry.videoPath, entry.audioPath}
+                                                    : entry.segmentFiles;
+            };
+
+            QList<qint64> entrySizes;
+            QList<qint64> existingSizes;
+            QHash<qint64, int> sizeCounts;
+            for (const CacheEntry& entry : entries) {
+                entrySizes.append(totalSize(entryFiles(entry)));
+                ++sizeCounts[entrySizes.last()];
+            }
+            for (const QStringList& files : existingFiles) {
+                existingSizes.append(totalSize(files));
+                ++sizeCounts[existingSizes.last()];
+            }
+
+            for (int i = 0; i < entries.size(); ++i) {
+                if (sizeCounts.value(entrySizes[i]) > 1) {
+                    entries[i].fingerprint = ContentFingerprint::compute(entryFiles(entries[i]));
+                }
+            }
+            for (int i = 0; i < existingFiles.size(); ++i) {
+                const bool needed = !existingHashed[i] && sizeCounts.value(existingSizes[i]) > 1;
+                existingFingerprints.append(needed ? ContentFingerprint::compute(existingFiles[i]) : QString());
+            }
+        }
+        if (!self) return;
+
+        QMetaObject::invokeMethod(self.data(), [self, entries, layout, skipped,
+                                                existingItems, existingFingerprints]() {
+            self->ui->wholsoueflie_importButton->setEnabled(true);
+            for (int i = 0; i < existingFingerprints.size(); ++i) {
+                if (existingItems[i] && !existingFingerprints[i].isEmpty()) {
+                    existingItems[i]->setFingerprint(existingFingerprints[i]);
+                }
+            }
+            const int duplicates = self->importCacheEntries(entries);
+
+            if (entries.isEmpty()) {
+                QMessageBox::information(self.data(), tr("导入"), tr("未在该目录中找到缓存视频"));
+            } else {
+                qCDebug(lcApp) << "缓存导入完成，布局:" << layout << "数量:" << entries.size()
+                         << "跳过的其他清晰度版本:" << skipped << "内容重复:" << duplicates;
+                if (duplicates > 0) {
+                    QMessageBox::information(self.data(), tr("导入"),
+                                             tr("有 %1 个视频与列表中已有的内容相同，已合并").arg(duplicates));
+                }
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+int MainWindow::importCacheEntries(const QList<CacheEntry>& entries)
+{
+    // 指纹相同的只保留第一行（列表中已有的优先）
+    QSet<QString> knownFingerprints;
+    for (VideoItem* item : m_tableManager->videoItems()) {
+        if (!item->fingerprint().isEmpty()) knownFingerprints.insert(item->fingerprint());
+    }
+
+    int duplicates = 0;
+    QList<VideoItem*> items;
+    items.reserve(entries.size());
+    for (const CacheEntry& entry : entries) {
+        if (!entry.fingerprint.isEmpty()) {
+            if (knownFingerprints.contains(entry.fingerprint)) {
+                qCDebug(lcApp) << "内容重复，跳过:" << entry.title << entry.directory;
+                ++duplicates;
+                continue;
+            }
+            knownFingerprints.insert(entry.fingerprint);
+        }
+
+        VideoItem* item = new VideoItem(m_tableManager);
+        item->setTitle(entry.title);
+        item->setVideoPath(entry.videoPath);
+        item->setAudioPath(entry.audioPath);
+        item->setUpName(entry.upName);
+        item->setUpUid(entry.upUid.toLongLong());
+        item->setSeries(entry.series);
+        item->setAvNumber(entry.avNumber);
+        item->setQualityId(entry.qualityId);
+        item->setTotalSize(entry.totalSize);
+        item->setDuration(qRound(entry.duration));
+        if (entry.createTime.isValid()) {
+            item->setCreateTime(entry.createTime.toMSecsSinceEpoch());
+        }
+        item->setSubtitleFiles(entry.subtitleFiles);
+        item->setSegmentFiles(entry.segmentFiles);
+        item->setFingerprint(entry.fingerprint);
+        items.append(item);
+    }
+
+    // 一次性添加，筛选/排序层只处理一次插入
+    m_tableManager->addRows(items);
+    return duplicates;
 }
 
 void MainWindow::on_settingButton_clicked()
 {
-    qDebug() << "========== OPENING SETTING DIALOG ==========";
-    qDebug() << "Current row count:" << m_tableManager->rowCount();
-    qDebug() << "Current column count:" << m_tableManager->tableModel()->columnCount();
+    qCDebug(lcApp) << "========== OPENING SETTING DIALOG ==========";
+    qCDebug(lcApp) << "Current row count:" << m_tableManager->rowCount();
+    qCDebug(lcApp) << "Current column count:" << m_tableManager->tableModel()->columnCount();
 
     Setting_Dialog dialog(m_tableManager, this); // 传入TableManager
     dialog.setWindowTitle(tr("设置"));
 
     if (dialog.exec() == QDialog::Accepted) {
-        qDebug() << "Setting_Dialog accepted, updating table headers";
-        m_tableManager->updateTableHeaders(); // 通过TableManager更新表头
+        qCDebug(lcApp) << "Setting_Dialog accepted";
     }
-    qDebug() << "========== SETTING DIALOG CLOSED ==========";
+    qCDebug(lcApp) << "========== SETTING DIALOG CLOSED ==========";
 }
 
 void MainWindow::on_addlineButton_clicked()
 {
-    qDebug() << "Current table model:" << ui->MaintableView->model();
-    qDebug() << "TableManager model:" << m_tableManager->tableModel();
-    qDebug() << "Add button clicked. Current row count:" << m_tableManager->rowCount();
+    qCDebug(lcApp) << "Current table model:" << ui->MaintableView->model();
+    qCDebug(lcApp) << "TableManager model:" << m_tableManager->tableModel();
+    qCDebug(lcApp) << "Add button clicked. Current row count:" << m_tableManager->rowCount();
 
     // 创建新行对象
-    int newIndex = m_tableManager->rowCount() + 1;
-    VideoItem* newItem = new VideoItem(newIndex, this);
+    VideoItem* newItem = new VideoItem(this);
 
-    qDebug() << "New VideoItem created:" << newItem;
+    qCDebug(lcApp) << "New VideoItem created:" << newItem;
 
     // 使用 TableManager 添加新行
     m_tableManager->addNewRow(newItem);
-    qDebug() << "After addNewRow: Rows=" << m_tableManager->rowCount();
+    qCDebug(lcApp) << "After addNewRow: Rows=" << m_tableManager->rowCount();
 }
 
 void MainWindow::on_delelineButton_clicked()
@@ -230,47 +463,46 @@ void MainWindow::on_outputButton_clicked()
     if (!outputDir.isEmpty()) {
         ui->outputAdd_Edit->setText(outputDir);
 
-        // 更新TableManager中的路径并保存
+        // 更新TableManager中的路径（由 SettingsStore 延迟写回）
         m_tableManager->setLastOutputPath(outputDir);
-        m_tableManager->savePathSettings();
     }
 }
 
 void MainWindow::on_mergeStartBtn_clicked()
 {
-    qDebug() << "=== 开始混流操作 ===";
-    qDebug() << "输出路径:" << ui->outputAdd_Edit->text();
+    qCDebug(lcApp) << "=== 开始混流操作 ===";
+    qCDebug(lcApp) << "输出路径:" << ui->outputAdd_Edit->text();
 
     // 检查输出路径
     QString outputPath = ui->outputAdd_Edit->text();
     if (outputPath.isEmpty()) {
         QMessageBox::warning(this, "错误", "输出路径不能为空");
-        qCritical() << "错误：输出路径为空";
+        qCCritical(lcApp) << "错误：输出路径为空";
         return;
     }
 
     QDir outputDir(outputPath);
     if (!outputDir.exists()) {
-        qWarning() << "输出路径不存在，尝试创建:" << outputPath;
+        qCWarning(lcApp) << "输出路径不存在，尝试创建:" << outputPath;
         if (!outputDir.mkpath(".")) {
             QMessageBox::warning(this, "错误", "无法创建输出目录");
-            qCritical() << "无法创建输出目录:" << outputPath;
+            qCCritical(lcApp) << "无法创建输出目录:" << outputPath;
             return;
         }
     }
 
-    // 检查MergeManager是否正在处理中
-    if (m_mergeManager->isProcessing()) {
-        qDebug() << "混流进程已在运行，跳过本次操作";
+    // 检查MergeManager是否正在处理中（尚未创建说明没有任务在运行）
+    if (m_mergeManager && m_mergeManager->isProcessing()) {
+        qCDebug(lcApp) << "混流进程已在运行，跳过本次操作";
         return;
     }
 
     // 根据导出模式执行操作
     if (m_rememberExportChoice) {
-        qDebug() << "使用记忆的导出模式:" << m_exportMode;
+        qCDebug(lcApp) << "使用记忆的导出模式:" << m_exportMode;
         performExportOperation(m_exportMode);
     } else {
-        qDebug() << "显示导出设置对话框";
+        qCDebug(lcApp) << "显示导出设置对话框";
         export_setting_dialog dialog(this, m_exportMode, m_rememberExportChoice);
         dialog.setWindowTitle(tr("生成模式设置"));
 
@@ -279,7 +511,7 @@ void MainWindow::on_mergeStartBtn_clicked()
             bool remember = dialog.rememberChoice();
 
             setExportSettings(newMode, remember);
-            qDebug() << "用户选择导出模式:" << newMode;
+            qCDebug(lcApp) << "用户选择导出模式:" << newMode;
             performExportOperation(newMode);
         }
     }
@@ -293,15 +525,15 @@ void MainWindow::setDeleteSettings(DeleteMode mode, bool remember)
     m_rememberDeleteChoice = remember;
 
     // 保存设置
-    QSettings settings;
-    settings.setValue("delete/remember", remember);
-    settings.setValue("delete/mode", static_cast<int>(mode));
+    SettingsStore& settings = SettingsStore::instance();
+    settings.setValue(SettingKeys::DeleteRemember, remember);
+    settings.setValue(SettingKeys::DeleteMode, static_cast<int>(mode));
 }
 
 void MainWindow::performDeleteOperation(DeleteMode mode)
 {
     if (!m_tableManager) {
-        qCritical() << "TableManager is null!";
+        qCCritical(lcApp) << "TableManager is null!";
         return;
     }
 
@@ -331,10 +563,57 @@ void MainWindow::setExportSettings(ExportMode mode, bool remember)
     m_rememberExportChoice = remember;
 
     if (remember) {
-        // 持久化存储到QSettings
-        QSettings settings;
-        settings.setValue("ExportMode", static_cast<int>(mode));
+        // 持久化存储（SettingsStore 延迟写回）
+        SettingsStore& settings = SettingsStore::instance();
+        settings.setValue(SettingKeys::ExportMode, static_cast<int>(mode));
+    }
+}
+
+// ===================== 导入选项函数组 =====================
+void MainWindow::setImportSettings(RenditionPolicy policy, int preferredCodecId, bool dedup)
+{
+    m_renditionPolicy = policy;
+    m_preferredCodecId = preferredCodecId;
+    m_dedupOnImport = dedup;
+
+    SettingsStore& settings = SettingsStore::instance();
+    settings.setValue(SettingKeys::ImportRenditionPolicy, static_cast<int>(policy));
+    settings.setValue(SettingKeys::ImportPreferredCodec, preferredCodecId);
+    settings.setValue(SettingKeys::ImportDedup, dedup);
+}
+
+int MainWindow::findDuplicateRow(const QString& fingerprint) const
+{
+    if (fingerprint.isEmpty()) return -1;
+
+    const QVector<VideoItem*>& items = m_tableManager->videoItems();
+    for (int row = 0; row < items.size(); ++row) {
+        if (items[row]->fingerprint() == fingerprint) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+// ===================== 混流选项函数组 =====================
+void MainWindow::setMergeOptions(const MergeOptions& options)
+{
+    m_mergeOptions = options;
+    if (m_mergeManager) {
+        m_mergeManager->setOptions(options);
     }
+
+    SettingsStore& settings = SettingsStore::instance();
+    settings.setValue(SettingKeys::MergeEmbedMetadata, options.embedMetadata);
+    settings.setValue(SettingKeys::MergeEmbedCover, options.embedCover);
+    settings.setValue(SettingKeys::MergeFastStart, options.fastStart);
+    settings.setValue(SettingKeys::MergeMuxDanmaku, options.muxDanmaku);
+    settings.setValue(SettingKeys::MergeMuxCcSubtitles, options.muxCcSubtitles);
+    settings.setValue(SettingKeys::MergeVerifyOutput, options.verifyOutput);
+    settings.setValue(SettingKeys::MergeCheckSources, options.checkSources);
+    settings.setValue(SettingKeys::MergeSalvageTruncated, options.salvageTruncated);
+    settings.setValue(SettingKeys::MergeSkipExported, options.skipExported);
+    settings.setValue(SettingKeys::MergeFormat, options.format);
 }
 
 // 修改状态显示更新方法
@@ -365,23 +644,23 @@ void MainWindow::updateExportStatusDisplay()
 //（ExportSingle/ExportSelected/ExportAll）调用对应的导出执行函数
 void MainWindow::performExportOperation(ExportMode mode)
 {
-    qDebug() << "=== 开始执行导出操作 ===";
-    qDebug() << "导出模式:" << mode << (mode == ExportSingle ? "(单个)" :
+    qCDebug(lcApp) << "=== 开始执行导出操作 ===";
+    qCDebug(lcApp) << "导出模式:" << mode << (mode == ExportSingle ? "(单个)" :
                                             mode == ExportSelected ? "(选中)" : "(全部)");
 
     // 检查混流管理器状态
-    if (m_mergeManager->isProcessing()) {
-        qDebug() << "导出中止：混流进程已在运行中";
+    if (m_mergeManager && m_mergeManager->isProcessing()) {
+        qCDebug(lcApp) << "导出中止：混流进程已在运行中";
         return;
     }
 
     QList<VideoItem*> pendingItems;
     QString outputPath = ui->outputAdd_Edit->text();
-    qDebug() << "输出路径:" << outputPath;
+    qCDebug(lcApp) << "输出路径:" << outputPath;
 
     // 空路径检查
     if (outputPath.isEmpty()) {
-        qDebug() << "错误：输出路径为空";
+        qCDebug(lcApp) << "错误：输出路径为空";
         QMessageBox::warning(this, "错误", "请先设置输出路径");
         return;
     }
@@ -389,109 +668,113 @@ void MainWindow::performExportOperation(ExportMode mode)
     // 验证输出目录
     QDir outputDir(outputPath);
     if (!outputDir.exists()) {
-        qDebug() << "输出目录不存在，尝试创建:" << outputPath;
+        qCDebug(lcApp) << "输出目录不存在，尝试创建:" << outputPath;
         if (!outputDir.mkpath(".")) {
-            qDebug() << "创建输出目录失败";
+            qCDebug(lcApp) << "创建输出目录失败";
             QMessageBox::warning(this, "错误", "无法创建输出目录");
             return;
         }
-        qDebug() << "输出目录创建成功";
+        qCDebug(lcApp) << "输出目录创建成功";
     }
 
     switch (mode) {
     case ExportSingle:
-        qDebug() << "模式：导出单个项目";
+        qCDebug(lcApp) << "模式：导出单个项目";
         if (auto index = ui->MaintableView->currentIndex(); index.isValid()) {
-            VideoItem* item = m_tableManager->videoItemAt(index.row());
-            qDebug() << "选中的项目: 行" << index.row()
-                     << "标题:" << item->data(COL_TITLE).toString()
-                     << "视频:" << item->data(COL_VIDEO_FILE).toString()
-                     << "音频:" << item->data(COL_AUDIO_FILE).toString();
+            VideoItem* item = m_tableManager->videoItemAt(m_tableManager->sourceRow(index));
+            if (!item) break;
+            qCDebug(lcApp) << "选中的项目: 行" << index.row()
+                     << "标题:" << item->title()
+                     << "视频:" << item->videoPath()
+                     << "音频:" << item->audioPath();
 
             pendingItems.append(item);
         } else {
-            qDebug() << "没有选中的项目";
+            qCDebug(lcApp) << "没有选中的项目";
             QMessageBox::information(this, "导出", "请先选择一个项目");
         }
         break;
 
     case ExportSelected: {
-        qDebug() << "模式：导出选中项目";
+        qCDebug(lcApp) << "模式：导出选中项目";
         auto selectedRows = ui->MaintableView->selectionModel()->selectedRows();
-        qDebug() << "选中的行数:" << selectedRows.count();
+        qCDebug(lcApp) << "选中的行数:" << selectedRows.count();
 
         for (const auto& index : selectedRows) {
-            // ...
+            if (VideoItem* item = m_tableManager->videoItemAt(m_tableManager->sourceRow(index))) {
+                pendingItems.append(item);
+            }
         }
 
         if (pendingItems.isEmpty()) {
-            qDebug() << "没有选中的项目";
+            qCDebug(lcApp) << "没有选中的项目";
             QMessageBox::information(this, "导出", "没有选中的项目");
         }
         break;
     }
 
     case ExportAll:
-        qDebug() << "模式：导出全部项目";
-        pendingItems = m_tableManager->videoItems();
-        qDebug() << "全部项目数量:" << pendingItems.size();
+        qCDebug(lcApp) << "模式：导出全部项目";
+        // 有筛选条件时只导出筛选结果（按当前显示顺序）
+        pendingItems = m_tableManager->visibleItems();
+        qCDebug(lcApp) << "全部项目数量:" << pendingItems.size();
 
         for (VideoItem* item : pendingItems) {
-            qDebug() << "  - 项目:"
-                     << "标题:" << item->data(COL_TITLE).toString()
-                     << "视频:" << item->data(COL_VIDEO_FILE).toString()
-                     << "音频:" << item->data(COL_AUDIO_FILE).toString();
+            qCDebug(lcApp) << "  - 项目:"
+                     << "标题:" << item->title()
+                     << "视频:" << item->videoPath()
+                     << "音频:" << item->audioPath();
         }
 
         if (pendingItems.isEmpty()) {
-            qDebug() << "没有可导出的项目";
+            qCDebug(lcApp) << "没有可导出的项目";
             QMessageBox::information(this, "导出", "没有可导出的项目");
         }
         break;
     }
 
-    qDebug() << "待导出项目总数:" << pendingItems.size();
+    qCDebug(lcApp) << "待导出项目总数:" << pendingItems.size();
 
     // 执行导出
     if (!pendingItems.isEmpty()) {
         switch (mode) {
         case ExportSingle:
-            qDebug() << "调用 exportItem()";
-            m_mergeManager->exportItem(pendingItems.first(), outputPath);
+            qCDebug(lcApp) << "调用 exportItem()";
+            mergeManager()->exportItem(pendingItems.first(), outputPath);
             break;
         case ExportSelected:
-            qDebug() << "调用 exportSelectedItems()";
-            m_mergeManager->exportSelectedItems(pendingItems, outputPath);
+            qCDebug(lcApp) << "调用 exportSelectedItems()";
+            mergeManager()->exportSelectedItems(pendingItems, outputPath);
             break;
         case ExportAll:
-            qDebug() << "调用 exportAllItems()";
-            m_mergeManager->exportAllItems(pendingItems, outputPath);
+            qCDebug(lcApp) << "调用 exportAllItems()";
+            mergeManager()->exportAllItems(pendingItems, outputPath);
             break;
         }
-        qDebug() << "导出命令已发送";
+        qCDebug(lcApp) << "导出命令已发送";
     } else {
-        qDebug() << "没有项目需要导出";
+        qCDebug(lcApp) << "没有项目需要导出";
     }
 
-    qDebug() << "=== 导出操作完成 ===";
+    qCDebug(lcApp) << "=== 导出操作完成 ===";
 }
 
 
 // ===================== 其他功能函数组 =====================
 void MainWindow::showMergeResultMessage(int successCount, int failedCount)
 {
-    qDebug() << "混流完成! 成功:" << successCount << "失败:" << failedCount;
+    qCDebug(lcApp) << "混流完成! 成功:" << successCount << "失败:" << failedCount;
 
     // 检查输出目录内容
     QString outputPath = ui->outputAdd_Edit->text();
     QDir outputDir(outputPath);
     if (outputDir.exists()) {
-        qDebug() << "输出目录内容:";
+        qCDebug(lcApp) << "输出目录内容:";
         for (QFileInfo file : outputDir.entryInfoList(QDir::Files)) {
-            qDebug() << "  - " << file.fileName() << "大小:" << file.size() << "字节";
+            qCDebug(lcApp) << "  - " << file.fileName() << "大小:" << file.size() << "字节";
         }
     } else {
-        qWarning() << "输出目录不存在:" << outputPath;
+        qCWarning(lcApp) << "输出目录不存在:" << outputPath;
     }
 
     QString message = QString("混流完成! 成功: %1, 失败: %2").arg(successCount).arg(failedCount);
@@ -500,9 +783,71 @@ void MainWindow::showMergeResultMessage(int successCount, int failedCount)
 
 
 void MainWindow::handleImportData(const QString& videoPath, const QString& audioPath, const QString& title)
+{
+    if (!m_dedupOnImport) {
+        addImportedItem(videoPath, audioPath, title, QString());
+        return;
+    }
+
+    // 内容与已有行相同时提示：指纹需要读文件，连同已有行缺少的指纹一起在线程池中计算
+    QList<QPointer<VideoItem>> unhashedItems;
+    QList<QStringList> unhashedFiles;
+    for (VideoItem* item : m_tableManager->videoItems()) {
+        if (item->fingerprint().isEmpty()) {
+            unhashedItems.append(item);
+            unhashedFiles.append(item->contentFiles());
+        }
+    }
+
+    QPointer<MainWindow> self(this);
+    QThreadPool::globalInstance()->start([self, videoPath, audioPath, title, unhashedItems, unhashedFiles]() {
+        auto totalSize = [](const QStringList& paths) {
+            qint64 size = 0;
+            for (const QString& path : paths) size += QFileInfo(path).size();
+            return size;
+        };
+
+        const QStringList files{videoPath, audioPath};
+        const QString fingerprint = ContentFingerprint::compute(files);
+
+        // 指纹包含文件大小：只有大小相同的行才需要补算指纹，其余留空
+        QStringList existingFingerprints;
+        const qint64 size = totalSize(files);
+        for (const QStringList& itemFiles : unhashedFiles) {
+            const bool sameSize = !fingerprint.isEmpty() && totalSize(itemFiles) == size;
+            existingFingerprints.append(sameSize ? ContentFingerprint::compute(itemFiles) : QString());
+        }
+        if (!self) return;
+
+        QMetaObject::invokeMethod(self.data(), [self, videoPath, audioPath, title, fingerprint,
+                                                unhashedItems, existingFingerprints]() {
+            for (int i = 0; i < existingFingerprints.size(); ++i) {
+                if (unhashedItems[i] && !existingFingerprints[i].isEmpty()) {
+                    unhashedItems[i]->setFingerprint(existingFingerprints[i]);
+                }
+            }
+
+            const int duplicateRow = self->findDuplicateRow(fingerprint);
+            if (duplicateRow >= 0) {
+                auto answer = QMessageBox::question(
+                    self.data(), tr("导入"), tr("该视频与第 %1 行的内容相同，仍要添加吗？").arg(duplicateRow + 1));
+                if (answer != QMessageBox::Yes || !self) {
+                    return;
+                }
+            }
+            self->addImportedItem(videoPath, audioPath, title, fingerprint);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MainWindow::addImportedItem(const QString& videoPath, const QString& audioPath,
+                                 const QString& title, const QString& fingerprint)
 {
     // 委托给 TableManager 添加新行
     m_tableManager->addVideoItem(videoPath, audioPath, title);
+    if (VideoItem* item = m_tableManager->videoItemAt(m_tableManager->rowCount() - 1)) {
+        item->setFingerprint(fingerprint);
+    }
 
     // 更新路径记忆
     if (!videoPath.isEmpty()) {
@@ -511,7 +856,6 @@ void MainWindow::handleImportData(const QString& videoPath, const QString& audio
     if (!audioPath.isEmpty()) {
         m_tableManager->setLastAudioPath(QFileInfo(audioPath).path());
     }
-    m_tableManager->savePathSettings();
 
     // 保留原有的 FFmpeg 预加载操作
     if (!videoPath.isEmpty() || !audioPath.isEmpty()) {
@@ -557,7 +901,7 @@ void MainWindow::previewItemAtRow(int row)
     }
 
     m_playbackWidget = new Playback_Widge(this);
-    QString title = item->data(COL_TITLE).toString();
+    QString title = item->title();
     m_playbackWidget->setWindowTitle("视频预览 - " + title);
     m_playbackWidget->setWindowFlags(Qt::Window);
     m_playbackWidget->show();
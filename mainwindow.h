@@ -2,17 +2,21 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include <QProgressBar>
+#include <QThreadPool>
 #include "data_models/tablemanager.h"
 #include "delegates/deletemode.h"
 #include "delegates/exportmode.h"
+#include "delegates/mergeoptions.h"
+#include "delegates/renditionpolicy.h"
 #include "playback_widge.h"
 #include "managers/mergemanager.h"
+#include "scanner/cacheentry.h"
 
 
 // 添加前向声明
 class ContextMenuManager; // 前向声明
 class MergeManager; // 前向声明
+class QTimer;
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -38,6 +42,16 @@ public:
     bool getExportRememberChoice() const { return m_rememberExportChoice; }
     void setExportSettings(ExportMode mode, bool remember);
 
+    // 混流选项访问方法
+    MergeOptions getMergeOptions() const { return m_mergeOptions; }
+    void setMergeOptions(const MergeOptions& options);
+
+    // 导入选项访问方法（多清晰度版本的挑选策略）
+    RenditionPolicy getRenditionPolicy() const { return m_renditionPolicy; }
+    int getPreferredCodecId() const { return m_preferredCodecId; }
+    bool getDedupOnImport() const { return m_dedupOnImport; }
+    void setImportSettings(RenditionPolicy policy, int preferredCodecId, bool dedup);
+
     // 统一的删除操作函数
     void performDeleteOperation(DeleteMode mode);
 
@@ -45,8 +59,13 @@ public:
     TableManager* tableManager() const { return m_tableManager; }
 
 
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
 signals:
     void totalProgressChanged(int progress); // 添加总进度改变信号
+    // 首次绘制后的会话恢复完成（没有快照时也会发出）
+    void sessionRestored();
 
 
 private slots:
@@ -68,9 +87,10 @@ private:
 
     // 添加 TableManager 成员变量
     TableManager* m_tableManager = nullptr; // 延迟初始化
-    MergeManager* m_mergeManager; // 添加 MergeManager 成员变量
-    ContextMenuManager* m_contextMenuManager;
-    QProgressBar* m_progressDelegate;
+    MergeManager* m_mergeManager = nullptr;             // 首次导出时创建
+    ContextMenuManager* m_contextMenuManager = nullptr; // 首次右键时创建
+    MergeManager* mergeManager();
+    ContextMenuManager* contextMenuManager();
 
     // 删除相关成员
     DeleteMode m_deleteMode = DeleteFirst;
@@ -80,12 +100,31 @@ private:
     ExportMode m_exportMode = ExportSingle;
     bool m_rememberExportChoice = false;
 
+    // 混流选项
+    MergeOptions m_mergeOptions;
+
+    // 导入选项
+    RenditionPolicy m_renditionPolicy = RenditionHighestQuality;
+    int m_preferredCodecId = 7;  // 7=AVC、12=HEVC、13=AV1
+    bool m_dedupOnImport = true; // 导入时识别内容相同的视频
+
+    // 启动时一次读取全部设置
+    void loadSettings();
+
     // 添加UI状态更新方法
     void updateExportStatusDisplay();
 
     // 执行导出操作
     void performExportOperation(ExportMode mode);
 
+    // 整个缓存目录导入：把扫描结果添加为表格行，返回因内容重复而跳过的数量
+    int importCacheEntries(const QList<CacheEntry>& entries);
+    // 与指纹相同的已有行（只比较已计算的指纹），没有时返回-1
+    int findDuplicateRow(const QString& fingerprint) const;
+    // 单行导入：查重完成后添加为表格行
+    void addImportedItem(const QString& videoPath, const QString& audioPath,
+                         const QString& title, const QString& fingerprint);
+
     Playback_Widge* m_playbackWidget = nullptr; // 添加预览窗口指针
 
     // 初始化路径记忆
@@ -95,11 +134,13 @@ private:
     // 加载路径设置
     void loadPathSettings();
 
-    // 混流管理
-    QList<VideoItem*> m_processingItems;
-    QList<VideoItem*> m_pendingItems;
-    int m_failedCount = 0;
-    int m_maxConcurrentProcesses = 3;
+    // 会话快照：启动时恢复表格，内容有变化时定期保存，退出时再保存一次
+    void restoreSessionSnapshot();
+    void saveSessionSnapshot(bool async);
+    QTimer* m_snapshotTimer = nullptr;
+    QThreadPool m_snapshotPool;      // 单线程，保证快照按顺序写入
+    quint64 m_snapshotRevision = 0;  // 最近一次保存时的表格版本
+    bool m_sessionRestored = false;  // 恢复之前不保存，否则空表格会覆盖上次的快照
 
     // 设置上下文菜单
     void setupContextMenu();
@@ -0,0 +1,125 @@
+#include "managers/applog.h"
+#include <QDateTime>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+Q_LOGGING_CATEGORY(lcApp, "memoria.app", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcTable, "memoria.table", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcMerge, "memoria.merge", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcSession, "memoria.session", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcScan, "memoria.scan", QtInfoMsg)
+
+namespace {
+
+const quint64 kSlotCount = 256;     // 2 的幂
+const int kCategorySize = 24;
+const int kTextSize = 160;          // UTF-16 码元，超出部分截断
+
+// 每个槽位带一个序号：写入中为奇数，写完为 2*票号+2；
+// 读取时前后两次序号一致且为期望值才采用，被并发覆盖的槽位直接跳过
+struct Slot {
+    std::atomic<quint64> sequence{0};
+    qint64 msecs = 0;
+    QtMsgType type = QtDebugMsg;
+    char category[kCategorySize] = {};
+    char16_t text[kTextSize] = {};
+    int textLength = 0;
+};
+
+Slot g_slots[kSlotCount];
+std::atomic<quint64> g_nextTicket{0};
+QtMessageHandler g_previousHandler = nullptr;
+
+void record(QtMsgType type, const char* category, const QString& message)
+{
+    const quint64 ticket = g_nextTicket.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = g_slots[ticket & (kSlotCount - 1)];
+
+    slot.sequence.store(2 * ticket + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.msecs = QDateTime::currentMSecsSinceEpoch();
+    slot.type = type;
+    qstrncpy(slot.category, category ? category : "default", kCategorySize);
+    int length = int(qMin<qsizetype>(message.size(), kTextSize));
+    // 不截断在代理对中间
+    if (length < message.size() && length > 0 && message.at(length - 1).isHighSurrogate()) {
+        --length;
+    }
+    std::memcpy(slot.text, message.utf16(), size_t(length) * sizeof(char16_t));
+    slot.textLength = length;
+
+    slot.sequence.store(2 * ticket + 2, std::memory_order_release);
+}
+
+const char* typeName(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg:    return "D";
+    case QtInfoMsg:     return "I";
+    case QtWarningMsg:  return "W";
+    case QtCriticalMsg: return "C";
+    case QtFatalMsg:    return "F";
+    }
+    return "?";
+}
+
+void messageHandler(QtMsgType type, const QMessageLogContext& context, const QString& message)
+{
+    record(type, context.category, message);
+
+    if (type == QtFatalMsg) {
+        std::fprintf(stderr, "---- 最近事件 ----\n");
+        for (const QString& line : AppLog::recentEvents(int(kSlotCount))) {
+            std::fprintf(stderr, "%s\n", qUtf8Printable(line));
+        }
+        std::fflush(stderr);
+    }
+
+    if (g_previousHandler) {
+        g_previousHandler(type, context, message);
+    } else {
+        std::fprintf(stderr, "%s\n", qUtf8Printable(qFormatLogMessage(type, context, message)));
+    }
+}
+
+} // namespace
+
+// ===================== 安装/读取 =====================
+void AppLog::install()
+{
+    static bool installed = false;
+    if (installed) return;
+    installed = true;
+    g_previousHandler = qInstallMessageHandler(messageHandler);
+}
+
+QStringList AppLog::recentEvents(int maxEvents)
+{
+    const quint64 end = g_nextTicket.load(std::memory_order_acquire);
+    const quint64 count = qMin<quint64>(quint64(qMax(maxEvents, 0)), qMin(end, kSlotCount));
+
+    QStringList lines;
+    lines.reserve(int(count));
+    for (quint64 ticket = end - count; ticket < end; ++ticket) {
+        const Slot& slot = g_slots[ticket & (kSlotCount - 1)];
+        const quint64 expected = 2 * ticket + 2;
+        if (slot.sequence.load(std::memory_order_acquire) != expected) continue;
+
+        const qint64 msecs = slot.msecs;
+        const QtMsgType type = slot.type;
+        char category[kCategorySize];
+        std::memcpy(category, slot.category, sizeof(category));
+        category[kCategorySize - 1] = '\0';
+        const QString text(reinterpret_cast<const QChar*>(slot.text), qBound(0, slot.textLength, kTextSize));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != expected) continue;
+
+        lines << QStringLiteral("%1 %2 %3: %4")
+                     .arg(QDateTime::fromMSecsSinceEpoch(msecs).toString("hh:mm:ss.zzz"),
+                          QLatin1String(typeName(type)), QLatin1String(category), text);
+    }
+    return lines;
+}
@@ -0,0 +1,30 @@
+#ifndef APPLOG_H
+#define APPLOG_H
+
+#include <QLoggingCategory>
+#include <QStringList>
+
+// 日志分类：用 qCDebug/qCInfo/qCWarning/qCCritical(分类) 输出
+// - 非 Debug 构建定义 QT_NO_DEBUG_OUTPUT，qCDebug 在编译期移除，参数不会求值
+// - Debug 构建中调试级别默认关闭，用 QT_LOGGING_RULES="memoria.*.debug=true" 打开；
+//   分类未启用时 qCDebug 只做一次布尔判断，不格式化
+Q_DECLARE_LOGGING_CATEGORY(lcApp)      // 主窗口、对话框、菜单
+Q_DECLARE_LOGGING_CATEGORY(lcTable)    // 表格模型与列
+Q_DECLARE_LOGGING_CATEGORY(lcMerge)    // 混流任务
+Q_DECLARE_LOGGING_CATEGORY(lcSession)  // 设置与会话快照
+Q_DECLARE_LOGGING_CATEGORY(lcScan)     // 缓存扫描与导入
+
+// 最近事件记录：
+// 通过分类过滤的每条消息都写入固定大小的环形缓冲区，写入方只做一次原子自增和定长拷贝，
+// 不加锁、不分配内存；出错时取出最近的事件附在错误记录中，严重错误（qFatal）时输出到 stderr
+namespace AppLog {
+
+// 安装消息处理函数（在 QApplication 构造前调用），原处理函数继续负责控制台输出
+void install();
+
+// 按时间顺序返回最近的事件（至多 maxEvents 条），格式 "hh:mm:ss.zzz 级别 分类: 消息"
+QStringList recentEvents(int maxEvents = 64);
+
+} // namespace AppLog
+
+#endif // APPLOG_H
@@ -1,20 +1,19 @@
 #include "managers/contextmenumanager.h"
 #include "mainwindow.h"
-#include <QDebug>
-#include <QSettings>
 #include <QFileDialog>
 #include <QMessageBox>
 #include "data_models/tablemanager.h"
+#include "managers/settingsstore.h"
+#include "media/ccsubtitleconverter.h"
+#include "media/segmentconcat.h"
+#include "managers/applog.h"
 
 ContextMenuManager::ContextMenuManager(MainWindow* mainWindow, QTableView* tableView, QObject* parent)
     : QObject(parent), m_mainWindow(mainWindow), m_tableView(tableView),
     m_contextMenu(new QMenu(tableView))
 {
-    // 初始化路径设置
-    loadPathSettings();
-
     if (!tableView) {
-        qCritical() << "ContextMenuManager: tableView is null!";
+        qCCritical(lcApp) << "ContextMenuManager: tableView is null!";
         return;
     }
 
@@ -26,32 +25,32 @@ ContextMenuManager::ContextMenuManager(MainWindow* mainWindow, QTableView* table
 
 void ContextMenuManager::setupContextMenu()
 {
-    qDebug() << "=== Entering setupContextMenu ===";
+    qCDebug(lcApp) << "=== Entering setupContextMenu ===";
 
     // 双重空指针保护
     if (!m_tableView || !m_mainWindow) {
-        qCritical() << "setupContextMenu: tableView or mainWindow is null!";
+        qCCritical(lcApp) << "setupContextMenu: tableView or mainWindow is null!";
         return;
     }
 
     // 确保菜单已创建
     if(!m_contextMenu) {
-        qCritical() << "Context menu not initialized!";
+        qCCritical(lcApp) << "Context menu not initialized!";
         return;
     }
-    qDebug() << "Setting up context menu for table view:" << m_tableView;
+    qCDebug(lcApp) << "Setting up context menu for table view:" << m_tableView;
 
     m_tableView->setContextMenuPolicy(Qt::CustomContextMenu);
     bool connected = connect(m_tableView, &QTableView::customContextMenuRequested,
                              this, &ContextMenuManager::showContextMenu);
-    qDebug() << "CustomContextMenu connection:" << connected;
+    qCDebug(lcApp) << "CustomContextMenu connection:" << connected;
 }
 
 void ContextMenuManager::showContextMenu(const QPoint& pos)
 {
     // 三重空指针保护
     if(!m_tableView || !m_mainWindow || !m_contextMenu) {
-        qCritical() << "Cannot show context menu - missing dependencies";
+        qCCritical(lcApp) << "Cannot show context menu - missing dependencies";
         return;
     }
 
@@ -64,7 +63,7 @@ void ContextMenuManager::showContextMenu(const QPoint& pos)
 
     // 安全设置预览数据
     if(m_previewAction) {
-        int row = index.row();
+        int row = m_mainWindow->tableManager()->sourceRow(index);
         m_previewAction->setData(row);
     }
 
@@ -88,7 +87,7 @@ void ContextMenuManager::onCustomContextMenuAction(QAction* action)
 
 void ContextMenuManager::createActions()
 {
-    qDebug() << "Creating context menu actions";
+    qCDebug(lcApp) << "Creating context menu actions";
 
     m_previewAction = new QAction("预览", this);
     m_deleteCurrentAction = new QAction("删除该行", this);
@@ -160,7 +159,7 @@ void ContextMenuManager::connectActions()
     connect(m_previewAction, &QAction::triggered, this, [this]() {
         if (!m_tableView || !m_mainWindow) return;
         if (auto index = m_tableView->currentIndex(); index.isValid()) {
-            emit previewRequested(index.row()); // 发射信号而不是直接调用
+            emit previewRequested(m_mainWindow->tableManager()->sourceRow(index)); // 发射信号而不是直接调用
         }
     });
 
@@ -182,7 +181,7 @@ void ContextMenuManager::connectActions()
         if (!m_tableView) return;
         QModelIndex index = m_tableView->currentIndex();
         if (index.isValid()) {
-            importFile(index.row(), index.column());
+            importFile(m_mainWindow->tableManager()->sourceRow(index), index.column());
         }
     });
 
@@ -191,26 +190,11 @@ void ContextMenuManager::connectActions()
         if (!m_tableView) return;
         QModelIndex index = m_tableView->currentIndex();
         if (index.isValid()) {
-            importTitleFolder(index.row());
+            importTitleFolder(m_mainWindow->tableManager()->sourceRow(index));
         }
     });
 }
 
-// ===================== 路径管理 =====================
-void ContextMenuManager::loadPathSettings()
-{
-    QSettings settings;
-    m_lastFileDialogPath = settings.value("Last/FileDialogPath", QDir::homePath()).toString();
-    m_lastTitleFolderPath = settings.value("Last/TitleFolderPath", QDir::homePath()).toString();
-}
-
-void ContextMenuManager::savePathSettings()
-{
-    QSettings settings;
-    settings.setValue("Last/FileDialogPath", m_lastFileDialogPath);
-    settings.setValue("Last/TitleFolderPath", m_lastTitleFolderPath);
-}
-
 // ===================== 文件导入 =====================
 void ContextMenuManager::importFile(int row, int col)
 {
@@ -220,14 +204,15 @@ void ContextMenuManager::importFile(int row, int col)
     QString filePath = QFileDialog::getOpenFileName(
         m_mainWindow,
         tr("选择媒体文件"),
-        m_lastFileDialogPath,
+        SettingsStore::instance().value(SettingKeys::LastFileDialogPath, QDir::homePath()),
         filter
         );
 
     if (filePath.isEmpty()) return;
 
     // 更新模型数据
-    QAbstractItemModel* model = m_tableView->model();
+    // row 为源模型行号（视图可能经过筛选/排序），直接写源模型
+    QAbstractItemModel* model = m_mainWindow->tableManager() ? m_mainWindow->tableManager()->tableModel() : nullptr;
     if (model) {
         QModelIndex targetIndex = model->index(row, col);
         model->setData(targetIndex, filePath);
@@ -242,49 +227,61 @@ void ContextMenuManager::importFile(int row, int col)
         }
     }
 
-    // 更新路径记忆
-    m_lastFileDialogPath = QFileInfo(filePath).absolutePath();
-    savePathSettings();
+    // 更新路径记忆（只写本次修改的键，不覆盖其他窗口记住的路径）
+    SettingsStore::instance().setValue(SettingKeys::LastFileDialogPath, QFileInfo(filePath).absolutePath());
 }
 
 // ===================== 标题文件夹导入 =====================
 void ContextMenuManager::importTitleFolder(int row)
 {
-    qDebug() << "=== 开始导入标题文件夹 ===";
-    qDebug() << "当前行:" << row;
+    qCDebug(lcApp) << "=== 开始导入标题文件夹 ===";
+    qCDebug(lcApp) << "当前行:" << row;
 
     if (!m_tableView || !m_mainWindow) {
-        qCritical() << "导入失败：tableView或mainWindow为空";
+        qCCritical(lcApp) << "导入失败：tableView或mainWindow为空";
         return;
     }
 
     QString folderPath = QFileDialog::getExistingDirectory(
         m_mainWindow,
         tr("选择标题文件夹"),
-        m_lastTitleFolderPath,
+        SettingsStore::instance().value(SettingKeys::LastTitleFolderPath, QDir::homePath()),
         QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks
         );
 
     if (folderPath.isEmpty()) {
-        qDebug() << "用户取消了文件夹选择";
+        qCDebug(lcApp) << "用户取消了文件夹选择";
         return;
     }
 
-    qDebug() << "选择的文件夹路径:" << folderPath;
+    qCDebug(lcApp) << "选择的文件夹路径:" << folderPath;
 
     QDir dir(folderPath);
     QString videoPath = findMediaFile(dir, "video");
     QString audioPath = findMediaFile(dir, "audio");
+    QStringList subtitlePaths = findSubtitleFiles(dir);
+
+    // 旧版缓存没有 video.m4s/audio.m4s，而是分段的 blv/flv
+    QStringList segmentPaths;
+    if (videoPath.isEmpty() && audioPath.isEmpty()) {
+        segmentPaths = SegmentConcat::findSegments(dir);
+        if (!segmentPaths.isEmpty()) {
+            videoPath = segmentPaths.first();
+            qCDebug(lcApp) << "找到分段FLV:" << segmentPaths.size() << "段";
+        }
+    }
     QString title = QFileInfo(folderPath).fileName();
 
-    qDebug() << "找到的视频文件:" << videoPath;
-    qDebug() << "找到的音频文件:" << audioPath;
-    qDebug() << "生成的标题:" << title;
+    qCDebug(lcApp) << "找到的视频文件:" << videoPath;
+    qCDebug(lcApp) << "找到的音频文件:" << audioPath;
+    qCDebug(lcApp) << "找到的CC字幕:" << subtitlePaths;
+    qCDebug(lcApp) << "生成的标题:" << title;
 
     // 更新模型
-    QAbstractItemModel* model = m_tableView->model();
+    // row 为源模型行号（视图可能经过筛选/排序），直接写源模型
+    QAbstractItemModel* model = m_mainWindow->tableManager() ? m_mainWindow->tableManager()->tableModel() : nullptr;
     if (!model) {
-        qCritical() << "模型为空，无法更新";
+        qCCritical(lcApp) << "模型为空，无法更新";
         return;
     }
 
@@ -293,7 +290,7 @@ void ContextMenuManager::importTitleFolder(int row)
     QModelIndex videoIndex = model->index(row, COL_VIDEO_FILE);
     QModelIndex audioIndex = model->index(row, COL_AUDIO_FILE);
 
-    qDebug() << "更新前值 - 标题:" << titleIndex.data().toString()
+    qCDebug(lcApp) << "更新前值 - 标题:" << titleIndex.data().toString()
              << " 视频:" << videoIndex.data().toString()
              << " 音频:" << audioIndex.data().toString();
 
@@ -302,24 +299,23 @@ void ContextMenuManager::importTitleFolder(int row)
     if (!videoPath.isEmpty()) {
         model->setData(videoIndex, videoPath);
     } else {
-        qWarning() << "未找到视频文件：" << dir.path();
+        qCWarning(lcApp) << "未找到视频文件：" << dir.path();
     }
 
     if (!audioPath.isEmpty()) {
         model->setData(audioIndex, audioPath);
     } else {
-        qWarning() << "未找到音频文件：" << dir.path();
+        qCWarning(lcApp) << "未找到音频文件：" << dir.path();
     }
 
     // 验证更新后的值
-    qDebug() << "更新后值 - 标题:" << titleIndex.data().toString()
+    qCDebug(lcApp) << "更新后值 - 标题:" << titleIndex.data().toString()
              << " 视频:" << videoIndex.data().toString()
              << " 音频:" << audioIndex.data().toString();
 
     // 保存路径
-    m_lastTitleFolderPath = QFileInfo(folderPath).absolutePath();
-    savePathSettings();
-    qDebug() << "=== 标题文件夹导入完成 ===";
+    SettingsStore::instance().setValue(SettingKeys::LastTitleFolderPath, QFileInfo(folderPath).absolutePath());
+    qCDebug(lcApp) << "=== 标题文件夹导入完成 ===";
 
     if (model) {
         // 更新模型
@@ -333,23 +329,41 @@ void ContextMenuManager::importTitleFolder(int row)
             tm->updateVideoItem(row, COL_TITLE, title);
             tm->updateVideoItem(row, COL_VIDEO_FILE, videoPath);
             tm->updateVideoItem(row, COL_AUDIO_FILE, audioPath);
+            if (VideoItem* item = tm->videoItemAt(row)) {
+                item->setSubtitleFiles(subtitlePaths);
+                item->setSegmentFiles(segmentPaths);
+            }
         }
     }
 }
 
 QString ContextMenuManager::findMediaFile(const QDir& dir, const QString& type)
 {
-    qDebug() << "在目录中查找媒体文件:" << dir.path() << "类型:" << type;
+    qCDebug(lcApp) << "在目录中查找媒体文件:" << dir.path() << "类型:" << type;
 
     // 直接查找固定文件名
     QString fixedFileName = type + ".m4s";
     QString fixedFilePath = dir.filePath(fixedFileName);
 
     if (QFile::exists(fixedFilePath)) {
-        qDebug() << "使用固定文件名:" << fixedFilePath;
+        qCDebug(lcApp) << "使用固定文件名:" << fixedFilePath;
         return fixedFilePath;
     }
 
-    qDebug() << "未找到匹配的" << type << "文件";
+    qCDebug(lcApp) << "未找到匹配的" << type << "文件";
     return QString();
 }
+
+QStringList ContextMenuManager::findSubtitleFiles(const QDir& dir)
+{
+    // CC字幕JSON与m4s放在同一目录，文件名一般为语言代码
+    QStringList subtitlePaths;
+    const QStringList jsonFiles = dir.entryList({"*.json"}, QDir::Files, QDir::Name);
+    for (const QString& fileName : jsonFiles) {
+        QString filePath = dir.filePath(fileName);
+        if (CcSubtitleConverter::isCcSubtitleFile(filePath)) {
+            subtitlePaths << filePath;
+        }
+    }
+    return subtitlePaths;
+}
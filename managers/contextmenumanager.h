@@ -36,8 +36,6 @@ private slots:
     void onCustomContextMenuAction(QAction* action);
 
 private:
-    void loadPathSettings();
-    void savePathSettings();
     void importFile(int row, int col);
     void importTitleFolder(int row);
 
@@ -65,12 +63,9 @@ private:
     QAction* m_exportSelectedAction;
     QAction* m_exportAllAction;
 
-    // 路径记忆
-    QString m_lastFileDialogPath;
-    QString m_lastTitleFolderPath;
-
     // 新增辅助函数声明
     QString findMediaFile(const QDir& dir, const QString& type);
+    QStringList findSubtitleFiles(const QDir& dir);
 };
 
 #endif // CONTEXTMENUMANAGER_H
@@ -0,0 +1,167 @@
+#include "managers/joblog.h"
+#include "managers/applog.h"
+#include "managers/settingsstore.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QStandardPaths>
+#include <utility>
+
+namespace {
+
+const qint64 kMaxQueuedBytes = 512 * 1024;      // 写入跟不上时最多缓存的记录
+const qint64 kMaxFileBytes = 2 * 1024 * 1024;   // 超过后轮转
+const int kRotatedFiles = 3;
+
+QJsonArray toJsonArray(const QStringList& list)
+{
+    QJsonArray array;
+    for (const QString& value : list) {
+        array.append(value);
+    }
+    return array;
+}
+
+} // namespace
+
+// ===================== 记录 =====================
+QByteArray JobRecord::toJsonLine() const
+{
+    QJsonObject object;
+    object["time"] = QDateTime::fromMSecsSinceEpoch(finishedAt).toString(Qt::ISODateWithMs);
+    object["event"] = event;
+    object["title"] = title;
+    if (!outputFile.isEmpty()) object["output"] = outputFile;
+    if (!program.isEmpty()) {
+        object["program"] = program;
+        object["arguments"] = toJsonArray(arguments);
+        object["exitCode"] = exitCode;
+    }
+    if (startedAt > 0) object["durationMs"] = finishedAt - startedAt;
+    if (!message.isEmpty()) object["message"] = message;
+    if (!stderrTail.isEmpty()) object["stderrTail"] = QString::fromUtf8(stderrTail);
+    if (!recentEvents.isEmpty()) object["recentEvents"] = toJsonArray(recentEvents);
+    return QJsonDocument(object).toJson(QJsonDocument::Compact) + '\n';
+}
+
+// ===================== 构造函数/析构函数 =====================
+JobLog& JobLog::instance()
+{
+    // 随 QCoreApplication 销毁；退出前写完队列
+    static JobLog* log = new JobLog(QCoreApplication::instance());
+    return *log;
+}
+
+JobLog::JobLog(QObject* parent)
+    : QObject(parent)
+{
+    m_writer.setMaxThreadCount(1);
+
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
+                this, &JobLog::flushAndWait);
+    }
+}
+
+JobLog::~JobLog()
+{
+    flushAndWait();
+}
+
+QString JobLog::defaultPath()
+{
+    // 程序目录在 Linux 安装后通常不可写，写入用户数据目录
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/logs/jobs.jsonl";
+}
+
+QString JobLog::path() const
+{
+    const QString configured = SettingsStore::instance().value(SettingKeys::JobLogPath);
+    return configured.isEmpty() ? defaultPath() : configured;
+}
+
+// ===================== 写入 =====================
+void JobLog::append(const JobRecord& record)
+{
+    const QByteArray line = record.toJsonLine();
+    const QString target = path();
+
+    QMutexLocker locker(&m_mutex);
+    m_path = target;
+    m_queue.append(line);
+    m_queuedBytes += line.size();
+    while (m_queuedBytes > kMaxQueuedBytes && m_queue.size() > 1) {
+        m_queuedBytes -= m_queue.takeFirst().size();
+        ++m_dropped;
+    }
+
+    if (!m_writerScheduled) {
+        m_writerScheduled = true;
+        m_writer.start([this]() { writePending(); });
+    }
+}
+
+void JobLog::flushAndWait()
+{
+    m_writer.waitForDone();
+}
+
+void JobLog::writePending()
+{
+    bool warned = false;
+    for (;;) {
+        QList<QByteArray> lines;
+        QString path;
+        int dropped = 0;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_queue.isEmpty()) {
+                m_writerScheduled = false;
+                return;
+            }
+            lines = std::exchange(m_queue, {});
+            m_queuedBytes = 0;
+            dropped = std::exchange(m_dropped, 0);
+            path = m_path;
+        }
+
+        QByteArray batch;
+        if (dropped > 0) {
+            batch += QJsonDocument(QJsonObject{
+                {"time", QDateTime::currentDateTime().toString(Qt::ISODateWithMs)},
+                {"event", "dropped"},
+                {"count", dropped}}).toJson(QJsonDocument::Compact) + '\n';
+        }
+        for (const QByteArray& line : lines) {
+            batch += line;
+        }
+
+        QDir().mkpath(QFileInfo(path).absolutePath());
+        if (QFileInfo(path).size() + batch.size() > kMaxFileBytes) {
+            rotate(path);
+        }
+
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Append) || file.write(batch) != batch.size()) {
+            if (!warned) {
+                qCWarning(lcMerge) << "无法写入任务日志:" << path << file.errorString();
+                warned = true;
+            }
+        }
+    }
+}
+
+void JobLog::rotate(const QString& path)
+{
+    QFile::remove(QString("%1.%2").arg(path).arg(kRotatedFiles));
+    for (int i = kRotatedFiles - 1; i >= 1; --i) {
+        QFile::rename(QString("%1.%2").arg(path).arg(i), QString("%1.%2").arg(path).arg(i + 1));
+    }
+    QFile::rename(path, path + ".1");
+}
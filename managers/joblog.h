@@ -0,0 +1,63 @@
+#ifndef JOBLOG_H
+#define JOBLOG_H
+
+#include <QByteArray>
+#include <QMutex>
+#include <QObject>
+#include <QStringList>
+#include <QThreadPool>
+
+// 单个导出任务的结构化记录，写为一行JSON
+struct JobRecord {
+    QString event;             // succeeded / ffmpeg_failed / verify_failed / start_failed / source_truncated
+    QString title;
+    QString outputFile;
+    QString program;
+    QStringList arguments;
+    int exitCode = 0;
+    QString message;           // 校验失败原因、截断说明等
+    QByteArray stderrTail;     // ffmpeg 标准错误输出的末尾（至多 JobLog::MaxStderrTail 字节）
+    qint64 startedAt = 0;      // 进程启动时间（毫秒），0 表示未启动进程
+    qint64 finishedAt = 0;
+    QStringList recentEvents;  // 见 AppLog::recentEvents
+
+    QByteArray toJsonLine() const;
+};
+
+// 任务日志（JSON Lines，只追加）：
+// - append() 在GUI线程序列化记录后放入队列，由单个后台线程顺序写入，并发失败的记录不会交错
+// - 队列超过上限时丢弃最旧的记录，并在文件中记下丢弃条数
+// - 文件超过上限时轮转为 .1/.2/.3
+// 位置由设置 log/jobLogPath 指定，为空时使用 defaultPath()
+class JobLog : public QObject
+{
+    Q_OBJECT
+public:
+    static const int MaxStderrTail = 4096;
+
+    static JobLog& instance();
+    static QString defaultPath();
+    QString path() const;
+
+    void append(const JobRecord& record);
+    // 等待已排队的记录写完（退出前调用）
+    void flushAndWait();
+
+private:
+    explicit JobLog(QObject* parent);
+    ~JobLog();
+
+    void writePending();
+    static void rotate(const QString& path);
+
+    mutable QMutex m_mutex;    // 保护以下队列状态
+    QList<QByteArray> m_queue;
+    qint64 m_queuedBytes = 0;
+    int m_dropped = 0;
+    QString m_path;
+    bool m_writerScheduled = false;
+
+    QThreadPool m_writer;      // 单线程，保证写入顺序
+};
+
+#endif // JOBLOG_H
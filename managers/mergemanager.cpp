@@ -1,12 +1,26 @@
 #include "mergemanager.h"
-#include <QDebug>
 #include <QFile>
 #include <QDir>
+#include <QFileInfo>
 #include <QRegularExpression>
 #include <QMessageBox>
 #include <QCoreApplication>
 #include <QProcess>
 #include <QTimer>
+#include <QPointer>
+#include <QThreadPool>
+#include <QUuid>
+#include <QDateTime>
+#include "media/fragmentindex.h"
+#include "media/danmakuconverter.h"
+#include "media/ccsubtitleconverter.h"
+#include "media/outputverifier.h"
+#include "media/sourceintegrity.h"
+#include "media/segmentconcat.h"
+#include "media/mp4boxreader.h"
+#include "media/contentfingerprint.h"
+#include "managers/applog.h"
+#include "managers/joblog.h"
 
 // 修改构造函数，初始化TableManager
 MergeManager::MergeManager(TableManager* tableManager, QObject *parent)
@@ -38,35 +52,166 @@ void MergeManager::exportAllItems(const QList<VideoItem*>& items, const QString&
 // ===================== 合并处理核心 =====================
 void MergeManager::startMergingProcess(const QList<VideoItem*>& items, const QString& outputPath)
 {
-    qDebug() << "------------------ FFmpeg Merging Started ------------------";
-    qDebug() << "Input Items:" << items.count();
-    qDebug() << "Output Path:" << outputPath;
+    qCInfo(lcMerge) << "开始混流:" << items.count() << "项，输出目录" << outputPath;
 
-    m_pendingItems = items;
+    m_pendingIds.clear();
+    for (VideoItem* item : items) {
+        m_pendingIds.append(item->id());
+    }
     m_totalItems = items.size();
     m_outputPath = outputPath;
     m_failedCount = 0;
     m_exportInProgress = true;
 
     emit totalProgressChanged(0);
+
+    m_manifest = OutputManifest();
+    if (m_options.checkSources || m_options.skipExported) {
+        m_pendingIds.clear();
+        screenAndQueue(items);
+        return;
+    }
     processNextItem();
 }
 
-void MergeManager::processNextItem()
+// 入队前的筛查，在线程池中进行：
+// 1. 检查输入文件是否下载完整（只跳读盒子头部）
+// 2. 计算内容指纹，跳过输出目录清单中已导出过的内容
+void MergeManager::screenAndQueue(const QList<VideoItem*>& items)
 {
-    qDebug() << "MergeManager::processNextItem - Pending items:" << m_pendingItems.size();
+    // VideoItem 只能在GUI线程访问，先取出路径
+    QList<quint64> ids;
+    QStringList videoPaths;
+    QStringList audioPaths;
+    QList<QStringList> fingerprintInputs;  // 已有指纹的项目为空
+    for (VideoItem* item : items) {
+        ids.append(item->id());
+        videoPaths.append(item->videoPath());
+        audioPaths.append(item->audioPath());
+        fingerprintInputs.append(item->fingerprint().isEmpty() ? item->contentFiles() : QStringList());
+    }
+
+    QPointer<MergeManager> self(this);
+    const bool checkSources = m_options.checkSources;
+    const bool skipExported = m_options.skipExported;
+    const QString outputPath = m_outputPath;
+    QThreadPool::globalInstance()->start([self, ids, videoPaths, audioPaths, fingerprintInputs,
+                                          checkSources, skipExported, outputPath]() {
+        QList<SourceIntegrity> videoResults;
+        QList<SourceIntegrity> audioResults;
+        QStringList fingerprints;
+        OutputManifest manifest(outputPath);
+        if (skipExported) manifest.load();
+
+        for (int i = 0; i < ids.size() && self; ++i) {
+            videoResults.append(checkSources ? SourceIntegrity::check(videoPaths[i]) : SourceIntegrity());
+            audioResults.append(checkSources ? SourceIntegrity::check(audioPaths[i]) : SourceIntegrity());
+            fingerprints.append(skipExported && !fingerprintInputs[i].isEmpty()
+                                    ? ContentFingerprint::compute(fingerprintInputs[i]) : QString());
+        }
+        if (!self) return;
+
+        QMetaObject::invokeMethod(self.data(), [self, ids, videoResults, audioResults,
+                                                fingerprints, manifest]() {
+            if (!self->m_exportInProgress) return;
+            self->m_manifest = manifest;
+
+            QList<quint64> accepted;
+            int truncatedCount = 0;
+            int exportedCount = 0;
+            for (int i = 0; i < ids.size(); ++i) {
+                VideoItem* item = self->itemForId(ids[i]);
+                if (!item) {
+                    // 检查期间该行已被删除
+                    self->m_totalItems--;
+                    continue;
+                }
+                if (!fingerprints[i].isEmpty()) {
+                    item->setFingerprint(fingerprints[i]);
+                }
+
+                // 相同内容已导出到该目录，直接视为成功
+                const QString exportedFile = self->m_options.skipExported
+                    ? self->m_manifest.find(item->fingerprint()) : QString();
+                if (!exportedFile.isEmpty()) {
+                    qCDebug(lcMerge) << "内容已导出过，跳过:" << item->title() << exportedFile;
+                    item->setSourceIssue("已导出过：" + QFileInfo(exportedFile).fileName());
+                    item->setHasError(false);
+                    item->setProgress(100);
+                    exportedCount++;
+                    continue;
+                }
+
+                QStringList issues;
+                if (videoResults[i].isTruncated()) issues << "视频" + videoResults[i].summary();
+                if (audioResults[i].isTruncated()) issues << "音频" + audioResults[i].summary();
+                item->setSourceIssue(issues.join("；"));
+                item->setSalvageDuration(0.0);
+
+                if (issues.isEmpty()) {
+                    accepted.append(item->id());
+                    continue;
+                }
+
+                // 挽救模式：只合并音视频都完整的前段，时长记录到表格中
+                const double salvage = self->m_options.salvageTruncated
+                    ? SourceIntegrity::salvageDuration(videoResults[i], audioResults[i]) : 0.0;
+                if (salvage > 0.0) {
+                    qCWarning(lcMerge) << "输入文件不完整，挽救前" << salvage << "秒:" << item->title();
+                    // 时长列显示为"hh:mm:ss（已截取）"
+                    item->setSalvageDuration(salvage);
+                    item->setSourceIssue(item->sourceIssue()
+                                         + QString("；已截取前 %1 秒").arg(salvage, 0, 'f', 1));
+                    accepted.append(item->id());
+                    continue;
+                }
+
+                // 截断的输入不进入合并队列
+                qCWarning(lcMerge) << "输入文件不完整:" << item->title() << issues;
+                item->setProgress(-1);
+                item->setHasError(true);
+                self->m_failedCount++;
+                truncatedCount++;
+
+                JobRecord record = jobRecord("source_truncated", item, nullptr);
+                record.message = issues.join("；");
+                JobLog::instance().append(record);
+            }
+
+            if (truncatedCount > 0) {
+                emit self->infoMessage(QString("%1 个项目的输入文件下载不完整，已跳过").arg(truncatedCount));
+            }
+            if (exportedCount > 0) {
+                emit self->infoMessage(QString("%1 个项目的内容已导出过，已跳过").arg(exportedCount));
+            }
+
+            self->m_pendingIds = accepted;
+            self->processNextItem();
+        }, Qt::QueuedConnection);
+    });
+}
 
-    if (m_pendingItems.isEmpty()) {
-        qDebug() << "No more items to process";
-        if (m_processingItems.isEmpty()) {
-            finishMergingProcess();
+void MergeManager::processNextItem()
+{
+    qCDebug(lcMerge) << "MergeManager::processNextItem - Pending items:" << m_pendingIds.size();
+
+    while (!m_pendingIds.isEmpty()) {
+        const quint64 id = m_pendingIds.takeFirst();
+        VideoItem* item = itemForId(id);
+        if (!item) {
+            // 排队期间该行已被删除
+            m_totalItems--;
+            continue;
         }
+        m_processingIds.append(id);
+        startFFmpegForItem(item);
         return;
     }
 
-    VideoItem* item = m_pendingItems.takeFirst();
-    m_processingItems.append(item);
-    startFFmpegForItem(item);
+    qCDebug(lcMerge) << "No more items to process";
+    if (m_processingIds.isEmpty()) {
+        finishMergingProcess();
+    }
 }
 
 
@@ -87,9 +232,8 @@ void MergeManager::parseFFmpegOutput(VideoItem* item, const QString& output)
 
 void MergeManager::startFFmpegForItem(VideoItem* item)
 {
-    qDebug() << "------------------ FFmpeg Process Launched ------------------";
-    qDebug() << "Video File:" << item->data(COL_VIDEO_FILE).toString();
-    qDebug() << "Audio File:" << item->data(COL_AUDIO_FILE).toString();
+    qCInfo(lcMerge) << "启动FFmpeg:" << item->title();
+    qCDebug(lcMerge) << "Video File:" << item->videoPath() << "Audio File:" << item->audioPath();
 
     // 1. 获取应用程序目录
     QString appDir = QCoreApplication::applicationDirPath();
@@ -104,12 +248,16 @@ void MergeManager::startFFmpegForItem(VideoItem* item)
         return;
     }
 
+    // 重新导出：清除上一次的失败状态，本次结果重新计入（如重新下载了截断的文件）
+    item->setHasError(false);
+    item->setProgress(0);
+
     // 4. 获取视频项数据
-    QString videoPath = item->data(COL_VIDEO_FILE).toString();
-    QString audioPath = item->data(COL_AUDIO_FILE).toString();
+    QString videoPath = item->videoPath();
+    QString audioPath = item->audioPath();
     // 修改后 - 直接使用传入的m_outputPath
     QString outputPath = m_outputPath;
-    QString title = item->data(COL_TITLE).toString();
+    QString title = item->title();
 
     if (outputPath.isEmpty()) {
         // 只有在之前没有错误的情况下才处理
@@ -118,7 +266,7 @@ void MergeManager::startFFmpegForItem(VideoItem* item)
             emit errorOccurred("输出目录未设置");
             item->setProgress(-1);
             item->setHasError(true);
-            m_processingItems.removeOne(item);
+            m_processingIds.removeOne(item->id());
         }
         return;
     }
@@ -132,11 +280,11 @@ void MergeManager::startFFmpegForItem(VideoItem* item)
     QDir outputDir(outputPath);
     if (!outputDir.exists()) {
         if (!outputDir.mkpath(".")) {
-            qWarning() << "Failed to create output directory:" << outputPath;
+            qCWarning(lcMerge) << "Failed to create output directory:" << outputPath;
             // 只有在之前没有处理过错误的情况下才标记失败
             if (item->progress() != -1) {
                 item->setProgress(-1);
-                m_processingItems.removeOne(item);
+                m_processingIds.removeOne(item->id());
                 m_failedCount++;
                 // 修改后 - 发送信号代替
                 emit errorOccurred("无法创建输出目录：" + outputPath);
@@ -156,29 +304,199 @@ void MergeManager::startFFmpegForItem(VideoItem* item)
     }
 
     // 7. 获取输出格式
-    QString format = "mp4"; // 默认MP4格式
+    QString format = m_options.format;
 
     // 8. 构建安全的输出文件路径
     QString outputFile = outputDir.filePath(safeTitle + "." + format);
 
-    // 9. 创建FFmpeg进程
+    // 9. 弹幕/CC字幕需先转换为文本字幕：转换在线程池中进行，完成后再启动FFmpeg
+    // 弹幕ASS依赖\move/\pos，MP4的mov_text无法表达，只在MKV中保留ASS轨道
+    QString danmakuPath;
+    if (m_options.muxDanmaku && format == "mkv") {
+        danmakuPath = DanmakuConverter::findForVideo(videoPath.isEmpty() ? audioPath : videoPath);
+    }
+    QStringList ccSubtitlePaths;
+    if (m_options.muxCcSubtitles) {
+        ccSubtitlePaths = item->subtitleFiles();
+    }
+    if (danmakuPath.isEmpty() && ccSubtitlePaths.isEmpty()) {
+        launchFFmpegProcess(item, ffmpegExe, outputFile, {});
+        return;
+    }
+
+    QPointer<MergeManager> self(this);
+    const quint64 id = item->id();
+    const QString textFormat = (format == "webm") ? "vtt" : "srt";
+
+    QThreadPool::globalInstance()->start([self, id, ffmpegExe, outputFile,
+                                          danmakuPath, ccSubtitlePaths, textFormat]() {
+        const QList<SubtitleInput> subtitles = prepareSubtitles(danmakuPath, ccSubtitlePaths, textFormat);
+        if (!self) {
+            for (const SubtitleInput& subtitle : subtitles) {
+                QFile::remove(subtitle.path);
+            }
+            return;
+        }
+
+        QMetaObject::invokeMethod(self.data(), [self, id, ffmpegExe, outputFile, subtitles]() {
+            VideoItem* item = self->itemForId(id);
+            if (!item) {
+                // 转换期间该行已被删除
+                for (const SubtitleInput& subtitle : subtitles) {
+                    QFile::remove(subtitle.path);
+                }
+                self->m_totalItems--;
+                self->finishJob(id);
+                return;
+            }
+            self->launchFFmpegProcess(item, ffmpegExe, outputFile, subtitles);
+        }, Qt::QueuedConnection);
+    });
+}
+
+// 在线程池中执行：把弹幕XML和CC字幕JSON转换为临时字幕文件
+QList<MergeManager::SubtitleInput> MergeManager::prepareSubtitles(const QString& danmakuPath,
+                                                                  const QStringList& ccSubtitlePaths,
+                                                                  const QString& textFormat)
+{
+    QList<SubtitleInput> subtitles;
+    const QString tempPrefix = QDir(QDir::tempPath()).filePath(
+        "memoria_" + QUuid::createUuid().toString(QUuid::Id128));
+
+    for (int i = 0; i < ccSubtitlePaths.size(); ++i) {
+        const QString& jsonPath = ccSubtitlePaths[i];
+        const QString outputPath = QString("%1_cc%2.%3").arg(tempPrefix).arg(i).arg(textFormat);
+
+        CcSubtitleConverter converter;
+        if (converter.convert(jsonPath, outputPath, textFormat)) {
+            // 字幕文件名一般为语言代码，如 zh-CN.json、ai-zh.json
+            subtitles.append({outputPath, QFileInfo(jsonPath).completeBaseName(), true, converter.cueCount()});
+        } else {
+            qCWarning(lcMerge) << "CC字幕转换失败:" << jsonPath << converter.errorString();
+        }
+    }
+
+    if (!danmakuPath.isEmpty()) {
+        const QString assPath = tempPrefix + "_danmaku.ass";
+        DanmakuConverter converter;
+        if (converter.convert(danmakuPath, assPath)) {
+            subtitles.append({assPath, "弹幕", true, converter.commentCount()});
+        } else {
+            qCWarning(lcMerge) << "弹幕转换失败:" << danmakuPath << converter.errorString();
+        }
+    }
+
+    return subtitles;
+}
+
+void MergeManager::launchFFmpegProcess(VideoItem* item, const QString& ffmpegExe,
+                                       const QString& outputFile, const QList<SubtitleInput>& subtitles)
+{
+    QString videoPath = item->videoPath();
+    QString audioPath = item->audioPath();
+    QString format = m_options.format;
+
+    // 10. 创建FFmpeg进程
     QProcess* ffmpegProcess = new QProcess(this);
-    ffmpegProcess->setProperty("videoItem", QVariant::fromValue<VideoItem*>(item));
+    ffmpegProcess->setProperty("itemId", item->id());
+    ffmpegProcess->setProperty("outputFile", outputFile);
+
+    // 临时字幕文件随进程一起清理
+    QStringList temporaryFiles;
+    for (const SubtitleInput& subtitle : subtitles) {
+        if (subtitle.temporary) {
+            temporaryFiles << subtitle.path;
+        }
+    }
+    if (!temporaryFiles.isEmpty()) {
+        connect(ffmpegProcess, &QObject::destroyed, [temporaryFiles]() {
+            for (const QString& path : temporaryFiles) {
+                QFile::remove(path);
+            }
+        });
+    }
 
-    // 10. 构建FFmpeg命令
+    // 11. 构建FFmpeg命令
     QStringList args;
+    QStringList mapArgs;
+    int inputIndex = 0;
 
     // 添加输入文件（直接使用路径）
-    if (!videoPath.isEmpty()) {
-        args << "-i" << videoPath;
+    const QStringList segments = item->segmentFiles();
+    if (!segments.isEmpty()) {
+        // 分段FLV（含单段）：concat分离器按顺序读取各段并平移时间戳，列表在进程启动后写入标准输入
+        args << SegmentConcat::inputArgs();
+        mapArgs << "-map" << QString("%1:v").arg(inputIndex) << "-map" << QString("%1:a?").arg(inputIndex);
+        inputIndex++;
+        const QByteArray concatList = SegmentConcat::buildConcatList(segments);
+        connect(ffmpegProcess, &QProcess::started, ffmpegProcess, [ffmpegProcess, concatList]() {
+            ffmpegProcess->write(concatList);
+            ffmpegProcess->closeWriteChannel();
+        });
+    } else if (!videoPath.isEmpty()) {
+        args << "-i" << inputUrl(videoPath);
+        mapArgs << "-map" << QString("%1:v").arg(inputIndex++);
+    }
+    if (!audioPath.isEmpty() && segments.isEmpty()) {
+        args << "-i" << inputUrl(audioPath);
+        mapArgs << "-map" << QString("%1:a").arg(inputIndex++);
+    }
+
+    // 字幕（CC字幕、弹幕ASS）作为独立字幕轨道在同一次混流中写入
+    for (const SubtitleInput& subtitle : subtitles) {
+        args << "-i" << subtitle.path;
+        mapArgs << "-map" << QString::number(inputIndex++);
     }
-    if (!audioPath.isEmpty()) {
-        args << "-i" << audioPath;
+
+    // 封面在混流时以attached_pic形式一并写入（MP4的covr），无需二次重写整个文件
+    QString coverPath;
+    if (m_options.embedCover) {
+        coverPath = findCoverImage(videoPath.isEmpty() ? audioPath : videoPath);
+    }
+    if (!coverPath.isEmpty() && format == "mp4") {
+        args << "-i" << coverPath;
+        mapArgs << "-map" << QString::number(inputIndex++);
+    }
+
+    // 有附加流时需要显式指定全部映射，否则ffmpeg每种类型只选一个流
+    if (!subtitles.isEmpty() || (!coverPath.isEmpty() && format == "mp4")) {
+        args << mapArgs;
+    }
+
+    if (!coverPath.isEmpty()) {
+        if (format == "mp4") {
+            // 封面是最后一个视频流
+            int coverStreamIndex = videoPath.isEmpty() ? 0 : 1;
+            args << QString("-disposition:v:%1").arg(coverStreamIndex) << "attached_pic";
+        } else if (format == "mkv") {
+            // MKV以附件形式保存封面
+            QString mimeType = coverPath.endsWith(".png", Qt::CaseInsensitive) ? "image/png" : "image/jpeg";
+            args << "-attach" << coverPath << "-metadata:s:t" << "mimetype=" + mimeType;
+        }
     }
 
     // 设置流复制参数
     args << "-c:v" << "copy" << "-c:a" << "copy";
 
+    // 字幕编码：MP4只支持mov_text，WebM只支持WebVTT，MKV直接保留ASS/SRT
+    if (!subtitles.isEmpty()) {
+        QString subtitleCodec = "copy";
+        if (format == "mp4") {
+            subtitleCodec = "mov_text";
+        } else if (format == "webm") {
+            subtitleCodec = "webvtt";
+        }
+        args << "-c:s" << subtitleCodec;
+        for (int i = 0; i < subtitles.size(); ++i) {
+            args << QString("-metadata:s:s:%1").arg(i) << "title=" + subtitles[i].title;
+        }
+    }
+
+    // 写入元数据（MP4为udta/meta/ilst，MKV为Tags）
+    if (m_options.embedMetadata) {
+        args << buildMetadataArgs(item);
+    }
+
     // 根据格式设置容器
     if (format == "mp4") {
         args << "-f" << "mp4";
@@ -190,139 +508,142 @@ void MergeManager::startFFmpegForItem(VideoItem* item)
         args << "-f" << "avi";
     }
 
+    // faststart：由分片输入的样本数预估 moov 大小并在文件头预留空间，
+    // 一次顺序写出 moov + mdat，避免 +faststart 对整个文件的二次重写
+    if (m_options.fastStart && format == "mp4") {
+        qint64 moovSize = estimateMoovSize({videoPath, audioPath}, coverPath, subtitles);
+        if (moovSize > 0) {
+            args << "-moov_size" << QString::number(moovSize);
+        } else {
+            // 输入不是分片MP4，无法预估，退回到ffmpeg的二次写入
+            args << "-movflags" << "+faststart";
+        }
+    }
+
+    // 挽救模式：在最后一个完整分片边界处截断，不读取被截断的尾部
+    if (item->salvageDuration() > 0.0) {
+        args << "-t" << QString::number(item->salvageDuration(), 'f', 3);
+    }
+
     // 添加输出文件参数
     args << "-y";
     args << outputFile; // 直接使用输出路径
 
-    // 11. 连接信号处理
+    // 12. 连接信号处理
     connect(ffmpegProcess, &QProcess::readyReadStandardOutput, this, [this, ffmpegProcess]() {
         QString output = ffmpegProcess->readAllStandardOutput();
-        VideoItem* item = ffmpegProcess->property("videoItem").value<VideoItem*>();
+        VideoItem* item = itemForId(ffmpegProcess->property("itemId").toULongLong());
         if (item) parseFFmpegOutput(item, output);
     });
 
     connect(ffmpegProcess, &QProcess::readyReadStandardError, this, [this, ffmpegProcess]() {
-        QString output = ffmpegProcess->readAllStandardError();
-        VideoItem* item = ffmpegProcess->property("videoItem").value<VideoItem*>();
-        if (item) parseFFmpegOutput(item, output);
+        const QByteArray output = ffmpegProcess->readAllStandardError();
+        // 保留末尾一段供任务日志使用（进度解析会读走全部输出）
+        QByteArray tail = ffmpegProcess->property("stderrTail").toByteArray() + output;
+        if (tail.size() > JobLog::MaxStderrTail) tail = tail.right(JobLog::MaxStderrTail);
+        ffmpegProcess->setProperty("stderrTail", tail);
+
+        VideoItem* item = itemForId(ffmpegProcess->property("itemId").toULongLong());
+        if (item) parseFFmpegOutput(item, QString::fromUtf8(output));
     });
 
     // 在进程完成信号处理中添加调试输出
     connect(ffmpegProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
             this, [this, ffmpegProcess](int exitCode, QProcess::ExitStatus exitStatus) {
-                VideoItem* item = ffmpegProcess->property("videoItem").value<VideoItem*>();
-                if (item) {
-                    qDebug() << "FFmpeg进程完成，退出码:" << exitCode << "退出状态:" << exitStatus;
-
+                const quint64 id = ffmpegProcess->property("itemId").toULongLong();
+                VideoItem* item = itemForId(id);
+                qCDebug(lcMerge) << "FFmpeg进程完成，退出码:" << exitCode << "退出状态:" << exitStatus;
+
+                if (!item) {
+                    // 导出期间该行已被删除，结果不计入统计
+                    qCDebug(lcMerge) << "项目已从列表中删除，忽略结果";
+                    m_totalItems--;
+                } else if (!item->hasError()) {
                     // 只有在之前没有错误的情况下才处理
-                    if (!item->hasError()) {
-                        if (exitStatus == QProcess::NormalExit && exitCode == 0) {
-                            qDebug() << "FFmpeg处理成功";
-                            item->setProgress(100);
-                        } else {
-                            qDebug() << "FFmpeg处理失败";
-                            item->setProgress(-1);
-                            item->setHasError(true);
-                            m_failedCount++;
-                            qDebug() << "失败计数增加，当前失败数:" << m_failedCount;
-
-                            QString errorOutput = ffmpegProcess->readAllStandardError();
-                            qDebug() << "FFmpeg错误输出:" << errorOutput;
-
-                            // 将错误输出保存到文件
-                            QFile errorLog(QCoreApplication::applicationDirPath() + "/ffmpeg_error.log");
-                            if (errorLog.open(QIODevice::WriteOnly | QIODevice::Append)) {
-                                errorLog.write(QString("Exit code: %1\n").arg(exitCode).toUtf8());
-                                errorLog.write("Command: " + ffmpegProcess->program().toUtf8() + " " + ffmpegProcess->arguments().join(" ").toUtf8() + "\n");
-                                errorLog.write("Error output:\n" + errorOutput.toUtf8() + "\n\n");
-                                errorLog.close();
-                            }
-                        }
-                    }
-
-                    m_processingItems.removeOne(item);
-                    qDebug() << "从处理队列中移除项目，当前处理中项目数:" << m_processingItems.size();
-                    ffmpegProcess->deleteLater();
-                    emit totalProgressChanged(calculateTotalProgress());
-
-                    if (!m_pendingItems.isEmpty()) {
-                        qDebug() << "有待处理项目，继续处理下一个";
-                        processNextItem();
-                    } else if (m_processingItems.isEmpty()) {
-                        qDebug() << "所有项目处理完成，调用完成函数";
-                        finishMergingProcess();
+                    if (exitStatus == QProcess::NormalExit && exitCode == 0 && m_options.verifyOutput) {
+                        // 校验要遍历整个输出文件的盒子结构，放到线程池中执行，结束后再移出处理队列
+                        JobRecord record = jobRecord(QString(), item, ffmpegProcess);
+                        record.exitCode = exitCode;
+                        verifyOutputAsync(item, record);
+                        ffmpegProcess->deleteLater();
+                        return;
+                    } else if (exitStatus == QProcess::NormalExit && exitCode == 0) {
+                        JobRecord record = jobRecord("succeeded", item, ffmpegProcess);
+                        record.exitCode = exitCode;
+                        completeItem(item, record);
+                    } else {
+                        qCWarning(lcMerge) << "FFmpeg处理失败，退出码:" << exitCode << item->title();
+                        item->setProgress(-1);
+                        item->setHasError(true);
+                        m_failedCount++;
+                        qCDebug(lcMerge) << "失败计数增加，当前失败数:" << m_failedCount;
+
+                        // 命令、退出码、错误输出末尾和最近事件写入任务日志
+                        JobRecord record = jobRecord("ffmpeg_failed", item, ffmpegProcess);
+                        record.exitCode = exitCode;
+                        if (exitStatus == QProcess::CrashExit) record.message = "FFmpeg进程异常退出";
+                        record.recentEvents = AppLog::recentEvents(32);
+                        qCDebug(lcMerge) << "FFmpeg错误输出:" << record.stderrTail;
+                        JobLog::instance().append(record);
                     }
                 }
+
+                ffmpegProcess->deleteLater();
+                finishJob(id);
             });
 
     // 在进程错误信号处理中添加调试输出
     connect(ffmpegProcess, &QProcess::errorOccurred,
             this, [this, ffmpegProcess](QProcess::ProcessError error) {
-                qDebug() << "FFmpeg Error Occurred:" << error;
-                VideoItem* item = ffmpegProcess->property("videoItem").value<VideoItem*>();
-                qDebug() << "FFmpeg进程错误:" << error;
-
-                // 只有在之前没有错误的情况下才处理
-                if (item && !item->hasError()) {
-                    // 只处理启动失败的情况，其他错误由finished信号处理
-                    if (error == QProcess::FailedToStart) {
-                        qDebug() << "FFmpeg启动失败";
-                        item->setProgress(-1);
-                        item->setHasError(true);
-                        m_failedCount++;
-                        qDebug() << "失败计数增加，当前失败数:" << m_failedCount;
-
-                        QString errorStr;
-                        switch(error) {
-                        case QProcess::FailedToStart:
-                            errorStr = "无法启动FFmpeg进程";
-                            break;
-                        default:
-                            return;  // 其他错误类型由finished信号处理
-                        }
-
-                        qDebug() << errorStr;
-                        emit errorOccurred("FFmpeg错误：" + errorStr);
-
-                        // 保存错误信息
-                        QFile errorLog(QCoreApplication::applicationDirPath() + "/ffmpeg_error.log");
-                        if (errorLog.open(QIODevice::WriteOnly | QIODevice::Append)) {
-                            errorLog.write(QString("Error: %1\n").arg(errorStr).toUtf8());
-                            errorLog.write("Command: " + ffmpegProcess->program().toUtf8() + " " + ffmpegProcess->arguments().join(" ").toUtf8() + "\n");
-                            errorLog.close();
-                        }
-
-                        m_processingItems.removeOne(item);
-                        qDebug() << "从处理队列中移除项目，当前处理中项目数:" << m_processingItems.size();
-                        ffmpegProcess->deleteLater();
-                        emit totalProgressChanged(calculateTotalProgress());
-
-                        if (!m_pendingItems.isEmpty()) {
-                            qDebug() << "有待处理项目，继续处理下一个";
-                            processNextItem();
-                        } else if (m_processingItems.isEmpty()) {
-                            qDebug() << "所有项目处理完成，调用完成函数";
-                            finishMergingProcess();
-                        }
-                    }
+                qCWarning(lcMerge) << "FFmpeg进程错误:" << error;
+
+                // 只处理启动失败的情况（此时不会发出finished信号），其他错误由finished信号处理
+                if (error != QProcess::FailedToStart) {
+                    return;
+                }
+
+                const quint64 id = ffmpegProcess->property("itemId").toULongLong();
+                VideoItem* item = itemForId(id);
+                const QString errorStr = "无法启动FFmpeg进程";
+                qCWarning(lcMerge) << errorStr;
+
+                if (!item) {
+                    m_totalItems--;
+                } else if (!item->hasError()) {
+                    // 只有在之前没有错误的情况下才处理
+                    item->setProgress(-1);
+                    item->setHasError(true);
+                    m_failedCount++;
+                    qCDebug(lcMerge) << "失败计数增加，当前失败数:" << m_failedCount;
+                    emit errorOccurred("FFmpeg错误：" + errorStr);
+
+                    // 保存错误信息
+                    JobRecord record = jobRecord("start_failed", item, ffmpegProcess);
+                    record.exitCode = -1;
+                    record.message = errorStr + "：" + ffmpegProcess->errorString();
+                    JobLog::instance().append(record);
                 }
+
+                ffmpegProcess->deleteLater();
+                finishJob(id);
             });
 
 
-    // 14. 启动进程
-    qDebug() << "Executing FFmpeg command:" << ffmpegExe << args;
+    // 13. 启动进程
+    qCDebug(lcMerge) << "Executing FFmpeg command:" << ffmpegExe << args;
+    ffmpegProcess->setProperty("startedAt", QDateTime::currentMSecsSinceEpoch());
     ffmpegProcess->start(ffmpegExe, args);
 
-    // 15. 添加超时处理
+    // 14. 添加超时处理
     QTimer::singleShot(5 * 60 * 1000, this, [ffmpegProcess, this]() {
         if (ffmpegProcess && ffmpegProcess->state() == QProcess::Running) {
-            qDebug() << "FFmpeg process timed out, terminating";
+            qCWarning(lcMerge) << "FFmpeg process timed out, terminating";
             ffmpegProcess->terminate();
 
             // 等待5秒强制终止
             QTimer::singleShot(5000, this, [ffmpegProcess, this]() {
                 if (ffmpegProcess && ffmpegProcess->state() == QProcess::Running) {
-                    qDebug() << "FFmpeg process still running, killing";
+                    qCWarning(lcMerge) << "FFmpeg process still running, killing";
                     ffmpegProcess->kill();
                 }
             });
@@ -332,6 +653,201 @@ void MergeManager::startFFmpegForItem(VideoItem* item)
 
 
 // ===================== 辅助函数 =====================
+QString MergeManager::inputUrl(const QString& path)
+{
+    // PC客户端缓存的m4s开头有填充字节，ffmpeg无法识别；
+    // 用subfile协议从 ftyp 处开始读取，无需先复制一份去掉填充的文件
+    const qint64 offset = Mp4BoxReader::findHeaderOffset(path);
+    if (offset > 0) {
+        return QString("subfile,,start,%1,end,0,,:%2").arg(offset).arg(path);
+    }
+    return path;
+}
+
+QStringList MergeManager::buildMetadataArgs(VideoItem* item) const
+{
+    // 未填写的字段为空，不写入元数据
+    const QString title = item->title().trimmed();
+    const QString upName = item->upName().trimmed();
+    const QString upUid = item->upUid() > 0 ? QString::number(item->upUid()) : QString();
+    const QString series = item->series().trimmed();
+    const QString avNumber = item->avNumber().trimmed();
+
+    QStringList args;
+    if (!title.isEmpty()) {
+        args << "-metadata" << "title=" + title;
+    }
+    if (!upName.isEmpty()) {
+        args << "-metadata" << "artist=" + upName;
+    }
+    if (!series.isEmpty()) {
+        args << "-metadata" << "album=" + series;
+    }
+
+    // av/bv号与UP主UID没有对应的标准标签，合并写入注释
+    QStringList comment;
+    if (!avNumber.isEmpty()) {
+        comment << avNumber;
+    }
+    if (!upUid.isEmpty()) {
+        comment << "UID:" + upUid;
+    }
+    if (!comment.isEmpty()) {
+        args << "-metadata" << "comment=" + comment.join(" ");
+    }
+    return args;
+}
+
+// 在线程池中执行：只使用传入的路径，不访问 VideoItem
+bool MergeManager::verifyOutput(const QString& format, const QString& videoPath, const QString& audioPath,
+                                double salvageDuration, const QString& outputFile, QString* errorString)
+{
+    // 目前只能校验MP4结构，其他容器只检查文件非空
+    if (format != "mp4") {
+        if (QFileInfo(outputFile).size() > 0) return true;
+        if (errorString) *errorString = "输出文件为空";
+        return false;
+    }
+
+    // 预期时长取自输入分片索引（只读盒子头部）
+    double expectedVideo = 0.0;
+    double expectedAudio = 0.0;
+    FragmentIndex index;
+    if (!videoPath.isEmpty() && index.build(videoPath) && index.isFragmented()) {
+        expectedVideo = index.playableDuration();
+    }
+    if (!audioPath.isEmpty() && index.build(audioPath) && index.isFragmented()) {
+        expectedAudio = index.playableDuration();
+    }
+
+    // 挽救模式下输出只包含截取的部分
+    if (salvageDuration > 0.0) {
+        expectedVideo = qMin(expectedVideo, salvageDuration);
+        expectedAudio = qMin(expectedAudio, salvageDuration);
+    }
+
+    OutputVerifier verifier;
+    if (!verifier.verify(outputFile, expectedVideo, expectedAudio)) {
+        if (errorString) *errorString = verifier.errorString();
+        return false;
+    }
+    return true;
+}
+
+void MergeManager::verifyOutputAsync(VideoItem* item, const JobRecord& record)
+{
+    QPointer<MergeManager> self(this);
+    const quint64 id = item->id();
+    const QString format = m_options.format;
+    const QString videoPath = item->videoPath();
+    const QString audioPath = item->audioPath();
+    const double salvageDuration = item->salvageDuration();
+
+    QThreadPool::globalInstance()->start([self, id, record, format, videoPath, audioPath, salvageDuration]() {
+        QString verifyError;
+        const bool ok = verifyOutput(format, videoPath, audioPath, salvageDuration,
+                                     record.outputFile, &verifyError);
+        if (!self) return;
+
+        QMetaObject::invokeMethod(self.data(), [self, id, record, ok, verifyError]() {
+            VideoItem* item = self->itemForId(id);
+            if (!item) {
+                // 校验期间该行已被删除，结果不计入统计
+                self->m_totalItems--;
+            } else if (ok) {
+                JobRecord succeeded = record;
+                succeeded.event = "succeeded";
+                self->completeItem(item, succeeded);
+            } else {
+                // ffmpeg正常退出但输出不完整（截断、样本表越界、时长不符）
+                qCWarning(lcMerge) << "输出校验失败:" << verifyError;
+                item->setProgress(-1);
+                item->setHasError(true);
+                self->m_failedCount++;
+
+                JobRecord failed = record;
+                failed.event = "verify_failed";
+                failed.message = verifyError;
+                JobLog::instance().append(failed);
+            }
+            self->finishJob(id);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MergeManager::completeItem(VideoItem* item, const JobRecord& record)
+{
+    qCDebug(lcMerge) << "FFmpeg处理成功";
+    item->setProgress(100);
+    if (m_options.skipExported) {
+        m_manifest.append(item->fingerprint(), record.outputFile);
+    }
+    // 成功的任务也记录命令和耗时，便于与失败记录对照
+    JobLog::instance().append(record);
+}
+
+qint64 MergeManager::estimateMoovSize(const QStringList& inputPaths, const QString& coverPath,
+                                      const QList<SubtitleInput>& subtitles) const
+{
+    // 非分片输出的 moov 大小由样本表决定，按每个样本的最坏情况取上限：
+    // stsz(4) + stts(8) + stsc(12) + co64(8)，视频轨道另有 ctts(8) + stss(4)
+    // 预留多出的空间会被 ffmpeg 写成 free 盒子
+    qint64 moovSize = 64 * 1024;  // mvhd/tkhd/stsd/元数据等固定部分
+
+    // attached_pic 封面写为 moov/udta/meta/ilst/covr，图片数据全部计入 moov
+    if (!coverPath.isEmpty()) {
+        const qint64 coverSize = QFileInfo(coverPath).size();
+        if (coverSize <= 0) {
+            return -1;
+        }
+        moovSize += coverSize + 16 * 1024;
+    }
+
+    // mov_text 字幕轨道（CC字幕、弹幕）：每个事件一个样本，事件之间的空档 ffmpeg 另写一个空样本
+    for (const SubtitleInput& subtitle : subtitles) {
+        moovSize += 4 * 1024 + (2 * qint64(subtitle.eventCount) + 1) * 32;
+    }
+
+    for (const QString& path : inputPaths) {
+        if (path.isEmpty()) continue;
+
+        FragmentIndex index;
+        if (!index.build(path) || !index.isFragmented()) {
+            return -1;
+        }
+
+        qint64 bytesPerSample = 32;
+        if (index.handlerType() == "vide") {
+            bytesPerSample += 12;
+        }
+        moovSize += qint64(index.totalSampleCount()) * bytesPerSample;
+    }
+    return moovSize;
+}
+
+
+QString MergeManager::findCoverImage(const QString& videoPath) const
+{
+    if (videoPath.isEmpty()) return QString();
+
+    // 缓存中的封面一般与m4s同目录或在上一级目录
+    static const QStringList coverNames = {
+        "cover.jpg", "cover.jpeg", "cover.png", "folder.jpg"
+    };
+
+    QDir dir = QFileInfo(videoPath).absoluteDir();
+    for (int level = 0; level < 2; ++level) {
+        for (const QString& name : coverNames) {
+            QString coverPath = dir.filePath(name);
+            if (QFile::exists(coverPath)) {
+                return coverPath;
+            }
+        }
+        if (!dir.cdUp()) break;
+    }
+    return QString();
+}
+
 // 在文件末尾添加进度解析函数实现
 int MergeManager::extractProgress(VideoItem* item, const QString& output)
 {
@@ -353,23 +869,60 @@ int MergeManager::extractProgress(VideoItem* item, const QString& output)
 
 int MergeManager::calculateTotalProgress() const
 {
-    if (m_processingItems.isEmpty()) return 0;
+    if (m_processingIds.isEmpty()) return 0;
 
     int total = 0;
-    for (VideoItem* item : m_processingItems) {
-        int progress = item->progress();
+    for (quint64 id : m_processingIds) {
+        VideoItem* item = itemForId(id);
+        int progress = item ? item->progress() : 0;
         if (progress < 0) progress = 0;
         if (progress > 100) progress = 100;
         total += progress;
     }
-    return total / m_processingItems.size();
+    return total / m_processingIds.size();
+}
+
+VideoItem* MergeManager::itemForId(quint64 id) const
+{
+    return m_tableManager ? m_tableManager->videoItemById(id) : nullptr;
+}
+
+void MergeManager::finishJob(quint64 id)
+{
+    m_processingIds.removeOne(id);
+    qCDebug(lcMerge) << "从处理队列中移除项目，当前处理中项目数:" << m_processingIds.size();
+    emit totalProgressChanged(calculateTotalProgress());
+
+    if (!m_pendingIds.isEmpty()) {
+        qCDebug(lcMerge) << "有待处理项目，继续处理下一个";
+        processNextItem();
+    } else if (m_processingIds.isEmpty()) {
+        qCDebug(lcMerge) << "所有项目处理完成，调用完成函数";
+        finishMergingProcess();
+    }
+}
+
+JobRecord MergeManager::jobRecord(const QString& event, const VideoItem* item, const QProcess* process)
+{
+    JobRecord record;
+    record.event = event;
+    record.title = item ? item->title() : QString();
+    record.finishedAt = QDateTime::currentMSecsSinceEpoch();
+    if (process) {
+        record.program = process->program();
+        record.arguments = process->arguments();
+        record.outputFile = process->property("outputFile").toString();
+        record.stderrTail = process->property("stderrTail").toByteArray();
+        record.startedAt = process->property("startedAt").toLongLong();
+    }
+    return record;
 }
 
 
 // ===================== 完成处理 =====================
 void MergeManager::finishMergingProcess()
 {
-    qDebug() << "MergeManager::finishMergingProcess - Finishing merge process";
+    qCDebug(lcMerge) << "MergeManager::finishMergingProcess - Finishing merge process";
     m_exportInProgress = false;
 
     // 计算成功数量 = 总项目数 - 失败数
@@ -6,6 +6,10 @@
 #include <QList>
 #include "data_models/videoitem.h"
 #include "data_models/tablemanager.h"  // 添加包含
+#include "delegates/mergeoptions.h"
+#include "media/outputmanifest.h"
+
+struct JobRecord;
 
 class MergeManager : public QObject
 {
@@ -23,6 +27,10 @@ public:
 
     bool isProcessing() const { return m_exportInProgress; }
 
+    // 混流选项
+    void setOptions(const MergeOptions& options) { m_options = options; }
+    const MergeOptions& options() const { return m_options; }
+
 signals:
     void progressChanged(int progress);
     void mergingFinished(int successCount, int failedCount);
@@ -34,23 +42,65 @@ signals:
 private:
     // 内部处理函数
     void processNextItem();
+    void screenAndQueue(const QList<VideoItem*>& items);
+    // 混流时附加的字幕输入
+    struct SubtitleInput {
+        QString path;
+        QString title;           // 字幕轨道标题
+        bool temporary = false;  // 转换生成的临时文件，进程结束后删除
+        int eventCount = 0;      // 字幕事件数（预估 moov 大小用）
+    };
+
     void startFFmpegForItem(VideoItem* item);
+    void launchFFmpegProcess(VideoItem* item, const QString& ffmpegExe,
+                             const QString& outputFile, const QList<SubtitleInput>& subtitles);
+    static QList<SubtitleInput> prepareSubtitles(const QString& danmakuPath,
+                                                 const QStringList& ccSubtitlePaths,
+                                                 const QString& textFormat);
     void parseFFmpegOutput(VideoItem* item, const QString& output);
     void finishMergingProcess();
 
     int extractProgress(VideoItem* item, const QString& output);
+
+    // 按行ID取回项目；导出期间行可能被删除，此时返回 nullptr
+    VideoItem* itemForId(quint64 id) const;
+    // 一个任务结束（成功、失败或行已删除）后移出处理队列并继续调度
+    void finishJob(quint64 id);
+    // 由进程属性（命令、启动时间、标准错误末尾）生成任务日志记录
+    static JobRecord jobRecord(const QString& event, const VideoItem* item, const QProcess* process);
+
+    // ffmpeg输入地址：跳过m4s开头的填充字节
+    static QString inputUrl(const QString& path);
+
+    // 元数据/封面
+    QStringList buildMetadataArgs(VideoItem* item) const;
+    QString findCoverImage(const QString& videoPath) const;
+
+    // 输出校验：遍历输出文件盒子结构并与输入时长比较（可在任意线程调用）
+    static bool verifyOutput(const QString& format, const QString& videoPath, const QString& audioPath,
+                             double salvageDuration, const QString& outputFile, QString* errorString);
+    // 在线程池中校验，结果回到GUI线程后记录并结束任务；record 为任务日志模板，事件按校验结果填写
+    void verifyOutputAsync(VideoItem* item, const JobRecord& record);
+    // 导出成功：进度置满，写入已导出清单和任务日志
+    void completeItem(VideoItem* item, const JobRecord& record);
+
+    // faststart：预估非分片输出的 moov 大小；MP4 封面（covr）整体写在 moov 中
+    qint64 estimateMoovSize(const QStringList& inputPaths, const QString& coverPath,
+                            const QList<SubtitleInput>& subtitles) const;
     int calculateTotalProgress() const;
 
     TableManager* m_tableManager;  // 添加TableManager指针
 
-    // 状态变量
-    QList<VideoItem*> m_processingItems;
-    QList<VideoItem*> m_pendingItems;
+    // 状态变量：任务以行ID引用，删除行不会留下悬空指针
+    QList<quint64> m_processingIds;
+    QList<quint64> m_pendingIds;
     QString m_outputPath;
     int m_failedCount = 0;
     int m_maxConcurrentProcesses = 3;
     bool m_exportInProgress = false;
     int m_totalItems = 0;
+    MergeOptions m_options;
+    OutputManifest m_manifest;  // 当前输出目录的导出清单
 };
 
 #endif // MERGEMANAGER_H
@@ -0,0 +1,93 @@
+#include "managers/settingsstore.h"
+#include "managers/applog.h"
+#include <QCoreApplication>
+#include <QSettings>
+#include <QTimer>
+#include <utility>
+
+namespace {
+
+const int kFlushDelayMs = 1000;
+
+} // namespace
+
+// ===================== 构造函数/析构函数 =====================
+SettingsStore& SettingsStore::instance()
+{
+    // 随 QCoreApplication 销毁；退出前同步写回
+    static SettingsStore* store = new SettingsStore(QCoreApplication::instance());
+    return *store;
+}
+
+SettingsStore::SettingsStore(QObject* parent)
+    : QObject(parent)
+    , m_flushTimer(new QTimer(this))
+{
+    m_writer.setMaxThreadCount(1);
+
+    QSettings settings;
+    const QStringList keys = settings.allKeys();
+    for (const QString& key : keys) {
+        m_values.insert(key, settings.value(key));
+    }
+    qCDebug(lcSession) << "SettingsStore loaded" << m_values.size() << "keys";
+
+    // 连续修改（如逐个勾选选项）合并为一次写回
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(kFlushDelayMs);
+    connect(m_flushTimer, &QTimer::timeout, this, &SettingsStore::flush);
+
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
+                this, &SettingsStore::flushAndWait);
+    }
+}
+
+SettingsStore::~SettingsStore()
+{
+    flushAndWait();
+}
+
+// ===================== 读写 =====================
+QVariant SettingsStore::rawValue(const QString& key) const
+{
+    return m_values.value(key);
+}
+
+void SettingsStore::setRawValue(const QString& key, const QVariant& value)
+{
+    auto it = m_values.constFind(key);
+    if (it != m_values.constEnd() && *it == value) {
+        return;
+    }
+
+    m_values.insert(key, value);
+    m_pending.insert(key, value);
+    m_flushTimer->start();
+    emit valueChanged(key, value);
+}
+
+// ===================== 写回 =====================
+void SettingsStore::flush()
+{
+    m_flushTimer->stop();
+    if (m_pending.isEmpty()) {
+        return;
+    }
+
+    // QSettings 可重入，后台线程使用独立实例写入
+    const QHash<QString, QVariant> pending = std::exchange(m_pending, {});
+    m_writer.start([pending]() {
+        QSettings settings;
+        for (auto it = pending.constBegin(); it != pending.constEnd(); ++it) {
+            settings.setValue(it.key(), it.value());
+        }
+        settings.sync();
+    });
+}
+
+void SettingsStore::flushAndWait()
+{
+    flush();
+    m_writer.waitForDone();
+}
@@ -0,0 +1,98 @@
+#ifndef SETTINGSSTORE_H
+#define SETTINGSSTORE_H
+
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <QVariant>
+
+class QTimer;
+
+// 类型化的设置键：值类型随键确定，读写处不再各自转换
+template <typename T>
+struct SettingKey {
+    using ValueType = T;
+    const char* name;
+};
+
+namespace SettingKeys {
+// 路径记忆（各处共用，修改哪个键只写哪个键）
+inline constexpr SettingKey<QString> LastFileDialogPath{"Last/FileDialogPath"};
+inline constexpr SettingKey<QString> LastTitleFolderPath{"Last/TitleFolderPath"};
+inline constexpr SettingKey<QString> LastVideoPath{"Last/VideoPath"};
+inline constexpr SettingKey<QString> LastAudioPath{"Last/AudioPath"};
+inline constexpr SettingKey<QString> LastOutputPath{"Last/OutputPath"};
+
+// 删除/导出设置（枚举按 int 保存）
+inline constexpr SettingKey<bool> DeleteRemember{"delete/remember"};
+inline constexpr SettingKey<int> DeleteMode{"delete/mode"};
+inline constexpr SettingKey<bool> RememberExportChoice{"RememberExportChoice"};
+inline constexpr SettingKey<int> ExportMode{"ExportMode"};
+
+// 混流选项
+inline constexpr SettingKey<bool> MergeEmbedMetadata{"merge/embedMetadata"};
+inline constexpr SettingKey<bool> MergeEmbedCover{"merge/embedCover"};
+inline constexpr SettingKey<bool> MergeFastStart{"merge/fastStart"};
+inline constexpr SettingKey<bool> MergeMuxDanmaku{"merge/muxDanmaku"};
+inline constexpr SettingKey<bool> MergeMuxCcSubtitles{"merge/muxCcSubtitles"};
+inline constexpr SettingKey<bool> MergeVerifyOutput{"merge/verifyOutput"};
+inline constexpr SettingKey<bool> MergeCheckSources{"merge/checkSources"};
+inline constexpr SettingKey<bool> MergeSalvageTruncated{"merge/salvageTruncated"};
+inline constexpr SettingKey<bool> MergeSkipExported{"merge/skipExported"};
+inline constexpr SettingKey<QString> MergeFormat{"merge/format"};
+
+// 导入选项
+inline constexpr SettingKey<int> ImportRenditionPolicy{"import/renditionPolicy"};
+inline constexpr SettingKey<int> ImportPreferredCodec{"import/preferredCodec"};
+inline constexpr SettingKey<bool> ImportDedup{"import/dedup"};
+
+// 任务日志位置（为空时使用 JobLog::defaultPath()）
+inline constexpr SettingKey<QString> JobLogPath{"log/jobLogPath"};
+} // namespace SettingKeys
+
+// 全局设置服务：
+// - 首次访问时从 QSettings 一次性读入内存，之后的读取不访问磁盘
+// - 写入只改内存并发出 valueChanged，停止修改 1 秒后把变化的键在后台线程写回
+// - 程序退出时同步写回尚未保存的修改
+// 仅在GUI线程使用
+class SettingsStore : public QObject
+{
+    Q_OBJECT
+public:
+    static SettingsStore& instance();
+
+    template <typename T>
+    T value(const SettingKey<T>& key, const typename SettingKey<T>::ValueType& defaultValue = T()) const
+    {
+        const QVariant stored = rawValue(QString::fromLatin1(key.name));
+        return stored.isValid() ? stored.value<T>() : defaultValue;
+    }
+
+    template <typename T>
+    void setValue(const SettingKey<T>& key, const typename SettingKey<T>::ValueType& value)
+    {
+        setRawValue(QString::fromLatin1(key.name), QVariant::fromValue(value));
+    }
+
+    QVariant rawValue(const QString& key) const;
+    void setRawValue(const QString& key, const QVariant& value);
+
+    // 立即把待写入的修改交给后台线程；flushAndWait 等待写入完成
+    void flush();
+    void flushAndWait();
+
+signals:
+    void valueChanged(const QString& key, const QVariant& value);
+
+private:
+    explicit SettingsStore(QObject* parent);
+    ~SettingsStore();
+
+    QHash<QString, QVariant> m_values;
+    QHash<QString, QVariant> m_pending;  // 尚未写回的修改
+    QTimer* m_flushTimer;
+    QThreadPool m_writer;                // 单线程，保证写回顺序
+};
+
+#endif // SETTINGSSTORE_H
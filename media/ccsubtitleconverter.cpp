@@ -0,0 +1,125 @@
+#include "media/ccsubtitleconverter.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace {
+
+// 时间格式 HH:MM:SS<sep>mmm（SRT 用逗号，WebVTT 用点）
+QString cueTime(double seconds, QChar separator)
+{
+    const qint64 ms = qMax<qint64>(0, qRound64(seconds * 1000));
+    return QString("%1:%2:%3%4%5")
+        .arg(ms / 3600000, 2, 10, QChar('0'))
+        .arg((ms / 60000) % 60, 2, 10, QChar('0'))
+        .arg((ms / 1000) % 60, 2, 10, QChar('0'))
+        .arg(separator)
+        .arg(ms % 1000, 3, 10, QChar('0'));
+}
+
+} // namespace
+
+// ===================== 解析 =====================
+bool CcSubtitleConverter::load(const QString& jsonPath)
+{
+    QFile file(jsonPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_errorString = file.errorString();
+        return false;
+    }
+    return loadData(file.readAll());
+}
+
+bool CcSubtitleConverter::loadData(const QByteArray& json)
+{
+    m_cues.clear();
+    m_errorString.clear();
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(json, &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        m_errorString = parseError.errorString();
+        return false;
+    }
+
+    const QJsonValue body = document.object().value("body");
+    if (!body.isArray()) {
+        m_errorString = "缺少body字段";
+        return false;
+    }
+
+    const QJsonArray entries = body.toArray();
+    m_cues.reserve(entries.size());
+    for (const QJsonValue& entry : entries) {
+        const QJsonObject object = entry.toObject();
+        CcSubtitleCue cue;
+        cue.from = object.value("from").toDouble();
+        cue.to = object.value("to").toDouble();
+        cue.content = object.value("content").toString();
+        if (cue.to > cue.from && !cue.content.isEmpty()) {
+            m_cues.append(cue);
+        }
+    }
+    return true;
+}
+
+bool CcSubtitleConverter::isCcSubtitleFile(const QString& jsonPath)
+{
+    QFile file(jsonPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    // 字幕文件很小，缓存目录中的 entry.json 等元数据文件没有 body 数组
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+    return document.isObject() && document.object().value("body").isArray();
+}
+
+// ===================== 输出 =====================
+QByteArray CcSubtitleConverter::toSrt() const
+{
+    QString srt;
+    srt.reserve(m_cues.size() * 64);
+    for (int i = 0; i < m_cues.size(); ++i) {
+        const CcSubtitleCue& cue = m_cues[i];
+        srt += QString::number(i + 1);
+        srt += '\n';
+        srt += cueTime(cue.from, ',');
+        srt += " --> ";
+        srt += cueTime(cue.to, ',');
+        srt += '\n';
+        srt += cue.content;
+        srt += "\n\n";
+    }
+    return srt.toUtf8();
+}
+
+QByteArray CcSubtitleConverter::toWebVtt() const
+{
+    QString vtt = "WEBVTT\n\n";
+    vtt.reserve(m_cues.size() * 64 + vtt.size());
+    for (const CcSubtitleCue& cue : m_cues) {
+        vtt += cueTime(cue.from, '.');
+        vtt += " --> ";
+        vtt += cueTime(cue.to, '.');
+        vtt += '\n';
+        vtt += cue.content;
+        vtt += "\n\n";
+    }
+    return vtt.toUtf8();
+}
+
+bool CcSubtitleConverter::convert(const QString& jsonPath, const QString& outputPath, const QString& format)
+{
+    if (!load(jsonPath)) {
+        return false;
+    }
+
+    QFile file(outputPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_errorString = file.errorString();
+        return false;
+    }
+    file.write(format == "vtt" ? toWebVtt() : toSrt());
+    return true;
+}
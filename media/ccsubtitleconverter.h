@@ -0,0 +1,39 @@
+#ifndef CCSUBTITLECONVERTER_H
+#define CCSUBTITLECONVERTER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+// 单条CC字幕
+struct CcSubtitleCue {
+    double from = 0.0;  // 开始时间（秒）
+    double to = 0.0;    // 结束时间（秒）
+    QString content;
+};
+
+// B站CC字幕JSON → SRT/WebVTT 转换器
+// JSON 格式：{"body": [{"from": 0.5, "to": 2.0, "content": "..."}, ...]}
+class CcSubtitleConverter
+{
+public:
+    bool load(const QString& jsonPath);
+    bool loadData(const QByteArray& json);
+
+    QByteArray toSrt() const;
+    QByteArray toWebVtt() const;
+    // format 为 "srt" 或 "vtt"
+    bool convert(const QString& jsonPath, const QString& outputPath, const QString& format);
+
+    int cueCount() const { return m_cues.size(); }
+    QString errorString() const { return m_errorString; }
+
+    // 判断文件是否为CC字幕JSON（扫描缓存目录时使用）
+    static bool isCcSubtitleFile(const QString& jsonPath);
+
+private:
+    QVector<CcSubtitleCue> m_cues;
+    QString m_errorString;
+};
+
+#endif // CCSUBTITLECONVERTER_H
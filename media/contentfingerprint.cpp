@@ -0,0 +1,36 @@
+#include "media/contentfingerprint.h"
+#include <QCryptographicHash>
+#include <QFile>
+#include <QtEndian>
+
+QString ContentFingerprint::compute(const QStringList& filePaths)
+{
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    bool hasInput = false;
+
+    for (const QString& path : filePaths) {
+        if (path.isEmpty()) continue;
+
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+            return QString();
+        }
+        const qint64 size = file.size();
+        const quint64 sizeLE = qToLittleEndian<quint64>(size);
+        hash.addData(QByteArrayView(reinterpret_cast<const char*>(&sizeLE), sizeof(sizeLE)));
+
+        if (size <= 3 * kSampleSize) {
+            // 小文件直接整体计算
+            hash.addData(file.readAll());
+        } else {
+            const qint64 offsets[] = {0, size / 2 - kSampleSize / 2, size - kSampleSize};
+            for (qint64 offset : offsets) {
+                if (!file.seek(offset)) return QString();
+                hash.addData(file.read(kSampleSize));
+            }
+        }
+        hasInput = true;
+    }
+
+    return hasInput ? QString::fromLatin1(hash.result().toHex()) : QString();
+}
@@ -0,0 +1,18 @@
+#ifndef CONTENTFINGERPRINT_H
+#define CONTENTFINGERPRINT_H
+
+#include <QString>
+#include <QStringList>
+
+// 抽样内容指纹：每个文件取开头、中间、结尾各 64KB 加上文件大小计算MD5
+// 读取量与文件大小无关，用于识别不同缓存目录/备份中的同一视频
+class ContentFingerprint
+{
+public:
+    // 多个文件（视频+音频，或全部分段）合成一个指纹，任一文件无法读取时返回空
+    static QString compute(const QStringList& filePaths);
+
+    static const qint64 kSampleSize = 64 * 1024;
+};
+
+#endif // CONTENTFINGERPRINT_H
@@ -0,0 +1,284 @@
+#include "media/danmakuconverter.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QXmlStreamReader>
+#include <algorithm>
+
+namespace {
+
+// ASS 时间格式 H:MM:SS.cc
+QString assTime(double seconds)
+{
+    const qint64 cs = qMax<qint64>(0, qRound64(seconds * 100));
+    return QString("%1:%2:%3.%4")
+        .arg(cs / 360000)
+        .arg((cs / 6000) % 60, 2, 10, QChar('0'))
+        .arg((cs / 100) % 60, 2, 10, QChar('0'))
+        .arg(cs % 100, 2, 10, QChar('0'));
+}
+
+// 估算文字宽度：ASCII 按半角，其余按全角
+double textWidth(const QString& text, int fontSize)
+{
+    double width = 0.0;
+    for (const QChar ch : text) {
+        width += (ch.unicode() < 0x80) ? fontSize * 0.5 : fontSize;
+    }
+    return width;
+}
+
+// 转义 ASS 控制字符
+QString escapeText(QString text)
+{
+    text.replace('{', QChar(0xFF5B));
+    text.replace('}', QChar(0xFF5D));
+    text.replace('\n', "\\N");
+    text.remove('\r');
+    return text;
+}
+
+} // namespace
+
+// ===================== XML解析 =====================
+bool DanmakuConverter::load(const QString& xmlPath)
+{
+    m_comments.clear();
+    m_droppedCount = 0;
+    m_errorString.clear();
+
+    QFile file(xmlPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_errorString = file.errorString();
+        return false;
+    }
+
+    QXmlStreamReader xml(&file);
+    while (!xml.atEnd()) {
+        if (xml.readNext() != QXmlStreamReader::StartElement || xml.name() != u"d") {
+            continue;
+        }
+
+        // p="出现时间,模式,字号,颜色,发送时间,弹幕池,用户哈希,弹幕ID"
+        const QXmlStreamAttributes attributes = xml.attributes();
+        const QStringView attr = attributes.value(u"p");
+        const QList<QStringView> fields = attr.split(u',');
+        if (fields.size() < 4) {
+            xml.skipCurrentElement();
+            continue;
+        }
+
+        DanmakuComment comment;
+        comment.time = fields[0].toDouble();
+        comment.mode = fields[1].toInt();
+        comment.fontSize = fields[2].toInt();
+        comment.color = fields[3].toUInt();
+
+        // 高级弹幕(7)和代码弹幕(8)无法转换为普通字幕
+        if (comment.mode < 1 || comment.mode > 6) {
+            xml.skipCurrentElement();
+            continue;
+        }
+
+        comment.text = xml.readElementText();
+        if (!comment.text.isEmpty()) {
+            m_comments.append(comment);
+        }
+    }
+
+    // 弹幕文件经常带有非法字符，已解析出的部分仍然可用
+    if (xml.hasError()) {
+        m_errorString = xml.errorString();
+        if (m_comments.isEmpty()) return false;
+    }
+
+    std::stable_sort(m_comments.begin(), m_comments.end(),
+                     [](const DanmakuComment& a, const DanmakuComment& b) { return a.time < b.time; });
+    return true;
+}
+
+// ===================== ASS生成 =====================
+QByteArray DanmakuConverter::toAss()
+{
+    const Options& o = m_options;
+    const int lineHeight = o.fontSize + 4;
+    const int rowCount = qMax(1, o.height / lineHeight);
+    m_droppedCount = 0;
+
+    // 滚动轨道：上一条弹幕完全进入屏幕的时间、以及其尾部离开屏幕左侧的时间
+    struct ScrollRow {
+        double fullyInAt = -1.0;
+        double exitAt = -1.0;
+    };
+    QVector<ScrollRow> scrollRows(rowCount);
+    QVector<double> topRows(rowCount, -1.0);
+    QVector<double> bottomRows(rowCount, -1.0);
+
+    QString ass;
+    ass.reserve(m_comments.size() * 100 + 1024);
+    ass += "[Script Info]\n"
+           "ScriptType: v4.00+\n"
+           "Collisions: Normal\n"
+           "WrapStyle: 2\n"
+           "ScaledBorderAndShadow: yes\n";
+    ass += QString("PlayResX: %1\nPlayResY: %2\n\n").arg(o.width).arg(o.height);
+    ass += "[V4+ Styles]\n"
+           "Format: Name, Fontname, Fontsize, PrimaryColour, SecondaryColour, OutlineColour, BackColour, "
+           "Bold, Italic, Underline, StrikeOut, ScaleX, ScaleY, Spacing, Angle, BorderStyle, Outline, "
+           "Shadow, Alignment, MarginL, MarginR, MarginV, Encoding\n";
+    ass += QString("Style: Danmaku,%1,%2,&H33FFFFFF,&H33FFFFFF,&H33000000,&H00000000,"
+                   "0,0,0,0,100,100,0,0,1,1,0,7,0,0,0,1\n\n").arg(o.fontName).arg(o.fontSize);
+    ass += "[Events]\n"
+           "Format: Layer, Start, End, Style, Name, MarginL, MarginR, MarginV, Effect, Text\n";
+
+    for (const DanmakuComment& comment : m_comments) {
+        const int fontSize = qMax(1, qRound(o.fontSize * comment.fontSize / 25.0));
+        const double width = textWidth(comment.text, fontSize);
+        const double t = comment.time;
+
+        QString tags;
+        double end = t + o.fixedDuration;
+
+        if (comment.mode <= 3 || comment.mode == 6) {
+            // 取第一条满足以下条件的轨道：上一条已完全进入屏幕，
+            // 且本条头部到达左侧时上一条尾部已经离开屏幕
+            const double speed = (o.width + width) / o.scrollDuration;
+            int row = -1;
+            for (int r = 0; r < rowCount; ++r) {
+                if (t >= scrollRows[r].fullyInAt && t + o.width / speed >= scrollRows[r].exitAt) {
+                    row = r;
+                    break;
+                }
+            }
+            if (row < 0) {
+                ++m_droppedCount;
+                continue;
+            }
+            scrollRows[row].fullyInAt = t + width / speed;
+            scrollRows[row].exitAt = t + o.scrollDuration;
+            end = t + o.scrollDuration;
+
+            const int y = row * lineHeight;
+            const int from = (comment.mode == 6) ? -qRound(width) : o.width;
+            const int to = (comment.mode == 6) ? o.width : -qRound(width);
+            tags = QString("\\an7\\move(%1,%2,%3,%2)").arg(from).arg(y).arg(to);
+        } else {
+            QVector<double>& rows = (comment.mode == 5) ? topRows : bottomRows;
+            int row = -1;
+            for (int r = 0; r < rowCount; ++r) {
+                if (t >= rows[r]) {
+                    row = r;
+                    break;
+                }
+            }
+            if (row < 0) {
+                ++m_droppedCount;
+                continue;
+            }
+            rows[row] = end;
+
+            if (comment.mode == 5) {
+                tags = QString("\\an8\\pos(%1,%2)").arg(o.width / 2).arg(row * lineHeight);
+            } else {
+                tags = QString("\\an2\\pos(%1,%2)").arg(o.width / 2).arg(o.height - row * lineHeight);
+            }
+        }
+
+        if (fontSize != o.fontSize) {
+            tags += QString("\\fs%1").arg(fontSize);
+        }
+        const quint32 rgb = comment.color & 0xFFFFFF;
+        if (rgb != 0xFFFFFF) {
+            const quint32 bgr = ((rgb & 0xFF) << 16) | (rgb & 0xFF00) | (rgb >> 16);
+            tags += QString("\\c&H%1&").arg(QString::number(bgr, 16).rightJustified(6, '0').toUpper());
+        }
+
+        ass += "Dialogue: 2,";
+        ass += assTime(t);
+        ass += ',';
+        ass += assTime(end);
+        ass += ",Danmaku,,0,0,0,,{";
+        ass += tags;
+        ass += '}';
+        ass += escapeText(comment.text);
+        ass += '\n';
+    }
+
+    return ass.toUtf8();
+}
+
+bool DanmakuConverter::convert(const QString& xmlPath, const QString& assPath)
+{
+    if (!load(xmlPath)) {
+        return false;
+    }
+
+    QFile file(assPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_errorString = file.errorString();
+        return false;
+    }
+    file.write(toAss());
+    return true;
+}
+
+// ===================== 辅助函数 =====================
+QString DanmakuConverter::findForVideo(const QString& videoPath)
+{
+    if (videoPath.isEmpty()) return QString();
+
+    // 安卓客户端为 danmaku.xml，其他客户端一般为 <cid>.xml；
+    // 其他XML（或同一目录下多个分P的 <cid>.xml）无法确定归属，不使用
+    static const QRegularExpression cidName(QStringLiteral("^\\d+\\.xml$"));
+    QDir dir = QFileInfo(videoPath).absoluteDir();
+    for (int level = 0; level < 2; ++level) {
+        const QString androidPath = dir.filePath("danmaku.xml");
+        if (QFile::exists(androidPath) && isDanmakuXml(androidPath)) {
+            return androidPath;
+        }
+        const QStringList cidFiles = dir.entryList({"*.xml"}, QDir::Files).filter(cidName);
+        if (cidFiles.size() == 1 && isDanmakuXml(dir.filePath(cidFiles.first()))) {
+            return dir.filePath(cidFiles.first());
+        }
+        if (!dir.cdUp()) break;
+    }
+    return QString();
+}
+
+bool DanmakuConverter::isDanmakuXml(const QString& xmlPath)
+{
+    QFile file(xmlPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    // 只读到根元素：B站弹幕XML的根元素为 <i>
+    QXmlStreamReader xml(&file);
+    while (!xml.atEnd()) {
+        if (xml.readNext() == QXmlStreamReader::StartElement) {
+            return xml.name() == QLatin1String("i");
+        }
+    }
+    return false;
+}
+
+int DanmakuConverter::countComments(const QString& xmlPath)
+{
+    QFile file(xmlPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+
+    // 分块查找 "<d p="，块之间保留 4 字节重叠，避免标记被切开
+    static const QByteArray marker = "<d p=";
+    int count = 0;
+    QByteArray carry;
+    while (!file.atEnd()) {
+        const QByteArray chunk = carry + file.read(1 << 20);
+        for (qsizetype pos = chunk.indexOf(marker); pos >= 0; pos = chunk.indexOf(marker, pos + marker.size())) {
+            ++count;
+        }
+        carry = chunk.right(marker.size() - 1);
+    }
+    return count;
+}
@@ -0,0 +1,56 @@
+#ifndef DANMAKUCONVERTER_H
+#define DANMAKUCONVERTER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+// 单条弹幕
+struct DanmakuComment {
+    double time = 0.0;         // 出现时间（秒）
+    int mode = 1;              // 1~3 滚动，4 底部，5 顶部，6 逆向滚动
+    int fontSize = 25;         // B站字号，25 为标准字号
+    quint32 color = 0xFFFFFF;  // RGB
+    QString text;
+};
+
+// B站弹幕XML → ASS字幕转换器
+// 流式解析XML，按时间顺序为滚动/顶部/底部弹幕分配互不碰撞的轨道
+class DanmakuConverter
+{
+public:
+    struct Options {
+        int width = 1920;              // ASS 画布宽度
+        int height = 1080;             // ASS 画布高度
+        int fontSize = 48;             // 标准字号(25)对应的 ASS 字号
+        double scrollDuration = 8.0;   // 滚动弹幕横穿屏幕的时长（秒）
+        double fixedDuration = 4.0;    // 顶部/底部弹幕停留时长（秒）
+        QString fontName = "Microsoft YaHei";
+    };
+
+    DanmakuConverter() = default;
+    explicit DanmakuConverter(const Options& options) : m_options(options) {}
+
+    bool load(const QString& xmlPath);
+    QByteArray toAss();
+    bool convert(const QString& xmlPath, const QString& assPath);
+
+    int commentCount() const { return m_comments.size(); }
+    int droppedCount() const { return m_droppedCount; } // 无可用轨道而丢弃的弹幕数
+    QString errorString() const { return m_errorString; }
+
+    // 查找视频所在目录（或上一级）中的弹幕XML（danmaku.xml 或 <cid>.xml），未找到返回空串
+    static QString findForVideo(const QString& videoPath);
+    // 根元素是否为 <i>（B站弹幕XML）
+    static bool isDanmakuXml(const QString& xmlPath);
+    // 只统计 <d> 元素个数，不解析内容；无法读取时返回 -1
+    static int countComments(const QString& xmlPath);
+
+private:
+    Options m_options;
+    QVector<DanmakuComment> m_comments;
+    int m_droppedCount = 0;
+    QString m_errorString;
+};
+
+#endif // DANMAKUCONVERTER_H
@@ -0,0 +1,209 @@
+#include "media/fragmentindex.h"
+#include "media/mp4boxreader.h"
+
+// ===================== 索引构建 =====================
+bool FragmentIndex::build(const QString& filePath)
+{
+    *this = FragmentIndex();
+
+    Mp4BoxReader reader(filePath);
+    if (!reader.open()) {
+        m_errorString = reader.errorString();
+        return false;
+    }
+    m_fileSize = reader.fileSize();
+
+    // PC客户端缓存的m4s开头有填充字节，从 ftyp 处开始解析
+    const qint64 startOffset = reader.headerOffset();
+    if (startOffset < 0) {
+        m_errorString = "不是有效的MP4文件";
+        return false;
+    }
+    qint64 offset = startOffset;
+    bool awaitingMdat = false;  // 上一个 moof 尚未遇到对应的 mdat
+    bool moofComplete = false;
+
+    while (offset < m_fileSize) {
+        Mp4Box box;
+        if (!reader.readBoxHeader(offset, box)) {
+            if (offset == startOffset) {
+                m_errorString = "不是有效的MP4文件";
+                return false;
+            }
+            // 剩余字节不足一个盒子头部，或者头部已损坏
+            m_missingTailBytes = qMax<qint64>(1, 8 - (m_fileSize - offset));
+            m_errorString = QString("盒子头部不完整，位置: %1").arg(offset);
+            break;
+        }
+
+        const bool boxComplete = box.end() <= m_fileSize;
+        if (!boxComplete) {
+            m_missingTailBytes = box.end() - m_fileSize;
+        }
+
+        if (box.type == "moov" && boxComplete) {
+            parseMoov(reader.readPayload(box));
+        } else if (box.type == "sidx" && boxComplete) {
+            parseSidx(reader.readPayload(box));
+        } else if (box.type == "moof") {
+            Mp4Fragment fragment;
+            fragment.offset = box.offset;
+            fragment.size = box.size;
+            moofComplete = boxComplete;
+            if (boxComplete && !parseMoof(reader.readPayload(box), fragment)) {
+                // 损坏的 moof 按不完整分片处理，不计入样本数和时长
+                moofComplete = false;
+                fragment.sampleCount = 0;
+                fragment.duration = 0;
+            }
+            m_fragments.append(fragment);
+            awaitingMdat = true;
+        } else if (box.type == "mdat" && awaitingMdat) {
+            Mp4Fragment& fragment = m_fragments.last();
+            fragment.size = box.end() - fragment.offset;
+            fragment.complete = moofComplete && boxComplete;
+            awaitingMdat = false;
+        }
+
+        if (!boxComplete) break;
+        offset = box.end();
+    }
+
+    return true;
+}
+
+void FragmentIndex::parseMoov(const QByteArray& data)
+{
+    const qint64 size = data.size();
+
+    // B站的m4s每个文件只有一条轨道，取第一条
+    Mp4Box trak, tkhd, mdia, mdhd, hdlr;
+    if (Mp4BoxReader::findChild(data, 0, size, "trak", trak)
+        && Mp4BoxReader::findChild(data, trak.payloadOffset(), trak.end(), "tkhd", tkhd)
+        && tkhd.payloadSize() >= 84) {
+        // tkhd 最后 8 字节为 16.16 定点的宽高
+        m_width = int(Mp4BoxReader::readU32(data, tkhd.end() - 8) >> 16);
+        m_height = int(Mp4BoxReader::readU32(data, tkhd.end() - 4) >> 16);
+    }
+    if (Mp4BoxReader::findChild(data, 0, size, "trak", trak)
+        && Mp4BoxReader::findChild(data, trak.payloadOffset(), trak.end(), "mdia", mdia)) {
+        if (Mp4BoxReader::findChild(data, mdia.payloadOffset(), mdia.end(), "mdhd", mdhd)) {
+            const qint64 pos = mdhd.payloadOffset();
+            const int version = Mp4BoxReader::readU8(data, pos);
+            m_timescale = Mp4BoxReader::readU32(data, pos + (version == 1 ? 20 : 12));
+        }
+        if (Mp4BoxReader::findChild(data, mdia.payloadOffset(), mdia.end(), "hdlr", hdlr)) {
+            m_handlerType = data.mid(hdlr.payloadOffset() + 8, 4);
+        }
+    }
+
+    // trex 中的默认样本时长（tfhd 未给出时使用）
+    Mp4Box mvex, trex;
+    if (Mp4BoxReader::findChild(data, 0, size, "mvex", mvex)
+        && Mp4BoxReader::findChild(data, mvex.payloadOffset(), mvex.end(), "trex", trex)) {
+        m_defaultSampleDuration = Mp4BoxReader::readU32(data, trex.payloadOffset() + 12);
+    }
+}
+
+void FragmentIndex::parseSidx(const QByteArray& data)
+{
+    const int version = Mp4BoxReader::readU8(data, 0);
+    const quint32 timescale = Mp4BoxReader::readU32(data, 8);
+    qint64 pos = (version == 0) ? 20 : 28;
+    const quint16 referenceCount = Mp4BoxReader::readU16(data, pos + 2);
+    pos += 4;
+
+    quint64 totalDuration = 0;
+    for (int i = 0; i < referenceCount; ++i, pos += 12) {
+        totalDuration += Mp4BoxReader::readU32(data, pos + 4);
+    }
+
+    if (timescale > 0) {
+        m_declaredDuration = double(totalDuration) / timescale;
+    }
+}
+
+bool FragmentIndex::parseMoof(const QByteArray& data, Mp4Fragment& fragment) const
+{
+    for (const Mp4Box& traf : Mp4BoxReader::childBoxes(data, 0, data.size())) {
+        if (traf.type != "traf") continue;
+
+        quint32 defaultDuration = m_defaultSampleDuration;
+        for (const Mp4Box& box : Mp4BoxReader::childBoxes(data, traf.payloadOffset(), traf.end())) {
+            const qint64 pos = box.payloadOffset();
+            const quint32 flags = Mp4BoxReader::readU32(data, pos) & 0xFFFFFF;
+
+            if (box.type == "tfhd") {
+                qint64 fieldPos = pos + 8;
+                if (flags & 0x01) fieldPos += 8;  // base_data_offset
+                if (flags & 0x02) fieldPos += 4;  // sample_description_index
+                if (flags & 0x08) {
+                    defaultDuration = Mp4BoxReader::readU32(data, fieldPos);
+                }
+            } else if (box.type == "tfdt") {
+                const int version = Mp4BoxReader::readU8(data, pos);
+                fragment.startTime = (version == 1) ? Mp4BoxReader::readU64(data, pos + 4)
+                                                    : Mp4BoxReader::readU32(data, pos + 4);
+            } else if (box.type == "trun") {
+                const quint32 sampleCount = Mp4BoxReader::readU32(data, pos + 4);
+                qint64 entryPos = pos + 8;
+                if (flags & 0x01) entryPos += 4;  // data_offset
+                if (flags & 0x04) entryPos += 4;  // first_sample_flags
+
+                // 每个样本的字段：时长/大小/标志/合成时间偏移，各4字节
+                int entrySize = 0;
+                if (flags & 0x100) entrySize += 4;
+                if (flags & 0x200) entrySize += 4;
+                if (flags & 0x400) entrySize += 4;
+                if (flags & 0x800) entrySize += 4;
+                // 样本数直接来自文件，超出盒子剩余长度说明已损坏，不能据此循环
+                if (entryPos > box.end() || quint64(sampleCount) * entrySize > quint64(box.end() - entryPos)) {
+                    return false;
+                }
+
+                fragment.sampleCount += sampleCount;
+                if (flags & 0x100) {
+                    // 每个样本单独给出时长
+                    for (quint32 i = 0; i < sampleCount; ++i) {
+                        fragment.duration += Mp4BoxReader::readU32(data, entryPos + qint64(i) * entrySize);
+                    }
+                } else {
+                    fragment.duration += quint64(sampleCount) * defaultDuration;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// ===================== 统计信息 =====================
+int FragmentIndex::completeFragmentCount() const
+{
+    int count = 0;
+    for (const Mp4Fragment& fragment : m_fragments) {
+        if (!fragment.complete) break;
+        ++count;
+    }
+    return count;
+}
+
+quint64 FragmentIndex::totalSampleCount() const
+{
+    quint64 total = 0;
+    for (const Mp4Fragment& fragment : m_fragments) {
+        total += fragment.sampleCount;
+    }
+    return total;
+}
+
+double FragmentIndex::playableDuration() const
+{
+    if (m_timescale == 0) return 0.0;
+
+    quint64 total = 0;
+    for (const Mp4Fragment& fragment : m_fragments) {
+        if (!fragment.complete) break;
+        total += fragment.duration;
+    }
+    return double(total) / m_timescale;
+}
@@ -0,0 +1,60 @@
+#ifndef FRAGMENTINDEX_H
+#define FRAGMENTINDEX_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+// 分片MP4（fMP4/m4s）中的一个分片：moof + mdat
+struct Mp4Fragment {
+    qint64 offset = 0;        // moof 起始位置
+    qint64 size = 0;          // moof + mdat 总大小
+    quint32 sampleCount = 0;  // 样本数
+    quint64 startTime = 0;    // tfdt 解码时间（轨道时间刻度）
+    quint64 duration = 0;     // 分片时长（轨道时间刻度）
+    bool complete = false;    // moof 与 mdat 均完整
+};
+
+// 分片索引：从头到尾只跳读盒子头部（以及很小的 moov/moof），不读取 mdat
+class FragmentIndex
+{
+public:
+    bool build(const QString& filePath);
+
+    bool isFragmented() const { return !m_fragments.isEmpty(); }
+    bool isTruncated() const { return m_missingTailBytes > 0; }
+    const QList<Mp4Fragment>& fragments() const { return m_fragments; }
+
+    qint64 fileSize() const { return m_fileSize; }
+    qint64 missingTailBytes() const { return m_missingTailBytes; }
+    QByteArray handlerType() const { return m_handlerType; } // "vide" / "soun"
+    quint32 timescale() const { return m_timescale; }
+    int width() const { return m_width; }    // 视频轨道分辨率（tkhd），音频为0
+    int height() const { return m_height; }
+
+    int completeFragmentCount() const;   // 从头开始连续完整的分片数
+    quint64 totalSampleCount() const;    // 所有已解析分片的样本数
+    double playableDuration() const;     // 连续完整分片的可播放时长（秒）
+    double declaredDuration() const { return m_declaredDuration; } // sidx 声明的时长（秒），未知为0
+
+    QString errorString() const { return m_errorString; }
+
+private:
+    void parseMoov(const QByteArray& data);
+    void parseSidx(const QByteArray& data);
+    // trun 声明的样本数超出盒子剩余长度时返回 false（文件损坏）
+    bool parseMoof(const QByteArray& data, Mp4Fragment& fragment) const;
+
+    QList<Mp4Fragment> m_fragments;
+    qint64 m_fileSize = 0;
+    qint64 m_missingTailBytes = 0;
+    QByteArray m_handlerType;
+    quint32 m_timescale = 0;
+    quint32 m_defaultSampleDuration = 0;
+    int m_width = 0;
+    int m_height = 0;
+    double m_declaredDuration = 0.0;
+    QString m_errorString;
+};
+
+#endif // FRAGMENTINDEX_H
@@ -0,0 +1,160 @@
+#include "media/mp4boxreader.h"
+#include <QtEndian>
+
+// ===================== 构造函数 =====================
+Mp4BoxReader::Mp4BoxReader(const QString& filePath)
+    : m_file(filePath)
+{
+}
+
+bool Mp4BoxReader::open()
+{
+    // 不使用缓冲：每次只读取盒子头部，避免为每次跳转预读整块数据
+    if (!m_file.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        return false;
+    }
+    m_fileSize = m_file.size();
+    return true;
+}
+
+void Mp4BoxReader::close()
+{
+    m_file.close();
+}
+
+// ===================== 文件读取 =====================
+QByteArray Mp4BoxReader::read(qint64 offset, qint64 length)
+{
+    if (offset < 0 || length <= 0 || offset >= m_fileSize) {
+        return QByteArray();
+    }
+    if (!m_file.seek(offset)) {
+        return QByteArray();
+    }
+    return m_file.read(qMin(length, m_fileSize - offset));
+}
+
+qint64 Mp4BoxReader::headerOffset()
+{
+    // 只检查文件开头的一小段，与文件大小无关
+    const QByteArray head = read(0, 64);
+    const int pos = head.indexOf("ftyp");
+    if (pos < 4) {
+        return -1;
+    }
+    return pos - 4;
+}
+
+qint64 Mp4BoxReader::findHeaderOffset(const QString& filePath)
+{
+    Mp4BoxReader reader(filePath);
+    if (!reader.open()) {
+        return -1;
+    }
+    return reader.headerOffset();
+}
+
+bool Mp4BoxReader::readBoxHeader(qint64 offset, Mp4Box& box)
+{
+    QByteArray header = read(offset, 16);
+    if (!parseBoxHeader(header, 0, box)) {
+        return false;
+    }
+
+    // size 为 0 表示盒子延伸到文件末尾
+    if (readU32(header, 0) == 0) {
+        box.size = m_fileSize - offset;
+    }
+    box.offset = offset;
+    return true;
+}
+
+QByteArray Mp4BoxReader::readPayload(const Mp4Box& box, qint64 maxBytes)
+{
+    if (box.payloadSize() > maxBytes || box.end() > m_fileSize) {
+        return QByteArray();
+    }
+    return read(box.payloadOffset(), box.payloadSize());
+}
+
+// ===================== 内存解析 =====================
+bool Mp4BoxReader::parseBoxHeader(const QByteArray& data, qint64 offset, Mp4Box& box)
+{
+    if (offset < 0 || offset + 8 > data.size()) {
+        return false;
+    }
+
+    quint64 size = readU32(data, offset);
+    box.type = data.mid(offset + 4, 4);
+    box.offset = offset;
+    box.headerSize = 8;
+
+    if (size == 1) {
+        if (offset + 16 > data.size()) {
+            return false;
+        }
+        size = readU64(data, offset + 8);
+        box.headerSize = 16;
+    } else if (size == 0) {
+        size = data.size() - offset;
+    }
+
+    if (size < quint64(box.headerSize)) {
+        return false;
+    }
+    box.size = qint64(size);
+    return true;
+}
+
+QList<Mp4Box> Mp4BoxReader::childBoxes(const QByteArray& data, qint64 begin, qint64 end)
+{
+    QList<Mp4Box> boxes;
+    end = qMin<qint64>(end, data.size());
+
+    qint64 offset = begin;
+    while (offset + 8 <= end) {
+        Mp4Box box;
+        if (!parseBoxHeader(data, offset, box) || box.end() > end) {
+            break;
+        }
+        boxes.append(box);
+        offset = box.end();
+    }
+    return boxes;
+}
+
+bool Mp4BoxReader::findChild(const QByteArray& data, qint64 begin, qint64 end,
+                             const char* type, Mp4Box& out)
+{
+    for (const Mp4Box& box : childBoxes(data, begin, end)) {
+        if (box.type == type) {
+            out = box;
+            return true;
+        }
+    }
+    return false;
+}
+
+quint8 Mp4BoxReader::readU8(const QByteArray& data, qint64 pos)
+{
+    if (pos < 0 || pos + 1 > data.size()) return 0;
+    return quint8(data.at(pos));
+}
+
+quint16 Mp4BoxReader::readU16(const QByteArray& data, qint64 pos)
+{
+    if (pos < 0 || pos + 2 > data.size()) return 0;
+    return qFromBigEndian<quint16>(data.constData() + pos);
+}
+
+quint32 Mp4BoxReader::readU32(const QByteArray& data, qint64 pos)
+{
+    if (pos < 0 || pos + 4 > data.size()) return 0;
+    return qFromBigEndian<quint32>(data.constData() + pos);
+}
+
+quint64 Mp4BoxReader::readU64(const QByteArray& data, qint64 pos)
+{
+    if (pos < 0 || pos + 8 > data.size()) return 0;
+    return qFromBigEndian<quint64>(data.constData() + pos);
+}
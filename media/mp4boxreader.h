@@ -0,0 +1,58 @@
+#ifndef MP4BOXREADER_H
+#define MP4BOXREADER_H
+
+#include <QFile>
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+// MP4 盒子(box)的位置信息
+struct Mp4Box {
+    QByteArray type;      // 4字节类型，如 "moov"、"moof"
+    qint64 offset = 0;    // 盒子起始位置
+    qint64 size = 0;      // 盒子总大小（含头部）
+    int headerSize = 0;   // 头部大小（8 或 16）
+
+    qint64 payloadOffset() const { return offset + headerSize; }
+    qint64 payloadSize() const { return size - headerSize; }
+    qint64 end() const { return offset + size; }
+};
+
+// 只读取盒子头部的 MP4 读取器，用于校验和建立索引，不解码媒体数据
+class Mp4BoxReader
+{
+public:
+    explicit Mp4BoxReader(const QString& filePath);
+
+    bool open();
+    void close();
+    qint64 fileSize() const { return m_fileSize; }
+    QString errorString() const { return m_file.errorString(); }
+
+    // 读取 offset 处的盒子头部，头部不完整或无效时返回 false
+    bool readBoxHeader(qint64 offset, Mp4Box& box);
+    // 读取盒子负载（不含头部），超过 maxBytes 或越过文件末尾时返回空
+    QByteArray readPayload(const Mp4Box& box, qint64 maxBytes = 64 * 1024 * 1024);
+    QByteArray read(qint64 offset, qint64 length);
+
+    // 第一个盒子(ftyp)的起始位置：正常文件为0，PC客户端缓存的m4s前面有若干填充字节；找不到时返回-1
+    qint64 headerOffset();
+    static qint64 findHeaderOffset(const QString& filePath);
+
+    // ---------- 内存中的盒子解析（moov/moof 读入内存后使用） ----------
+    static bool parseBoxHeader(const QByteArray& data, qint64 offset, Mp4Box& box);
+    static QList<Mp4Box> childBoxes(const QByteArray& data, qint64 begin, qint64 end);
+    static bool findChild(const QByteArray& data, qint64 begin, qint64 end,
+                          const char* type, Mp4Box& out);
+
+    static quint8 readU8(const QByteArray& data, qint64 pos);
+    static quint16 readU16(const QByteArray& data, qint64 pos);
+    static quint32 readU32(const QByteArray& data, qint64 pos);
+    static quint64 readU64(const QByteArray& data, qint64 pos);
+
+private:
+    QFile m_file;
+    qint64 m_fileSize = 0;
+};
+
+#endif // MP4BOXREADER_H
@@ -0,0 +1,53 @@
+#include "media/outputmanifest.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+OutputManifest::OutputManifest(const QString& outputDir)
+    : m_outputDir(outputDir)
+{
+}
+
+bool OutputManifest::load()
+{
+    m_entries.clear();
+
+    QFile file(QDir(m_outputDir).filePath(fileName()));
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return false;
+    }
+    while (!file.atEnd()) {
+        const QString line = QString::fromUtf8(file.readLine()).trimmed();
+        const int tab = line.indexOf('\t');
+        if (tab > 0) {
+            m_entries.insert(line.left(tab), line.mid(tab + 1));
+        }
+    }
+    return true;
+}
+
+QString OutputManifest::find(const QString& fingerprint) const
+{
+    if (fingerprint.isEmpty()) return QString();
+
+    const auto it = m_entries.constFind(fingerprint);
+    if (it == m_entries.constEnd()) return QString();
+
+    // 输出文件被删除后允许重新导出
+    const QString path = QDir(m_outputDir).filePath(it.value());
+    return QFileInfo::exists(path) ? path : QString();
+}
+
+bool OutputManifest::append(const QString& fingerprint, const QString& outputFile)
+{
+    if (fingerprint.isEmpty() || m_outputDir.isEmpty()) return false;
+
+    QFile file(QDir(m_outputDir).filePath(fileName()));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        return false;
+    }
+    const QString name = QFileInfo(outputFile).fileName();
+    file.write((fingerprint + '\t' + name + '\n').toUtf8());
+    m_entries.insert(fingerprint, name);
+    return true;
+}
@@ -0,0 +1,27 @@
+#ifndef OUTPUTMANIFEST_H
+#define OUTPUTMANIFEST_H
+
+#include <QHash>
+#include <QString>
+
+// 输出目录中的导出清单：记录已导出内容的指纹与输出文件名
+// 文件格式为每行 "指纹<TAB>文件名"，只追加写入
+class OutputManifest
+{
+public:
+    OutputManifest() = default;
+    explicit OutputManifest(const QString& outputDir);
+
+    bool load();
+    // 指纹已导出且输出文件仍然存在时返回输出文件路径
+    QString find(const QString& fingerprint) const;
+    bool append(const QString& fingerprint, const QString& outputFile);
+
+    static const char* fileName() { return ".memoria_manifest"; }
+
+private:
+    QString m_outputDir;
+    QHash<QString, QString> m_entries;  // 指纹 → 文件名
+};
+
+#endif // OUTPUTMANIFEST_H
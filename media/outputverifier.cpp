@@ -0,0 +1,193 @@
+#include "media/outputverifier.h"
+#include <QtMath>
+
+// ===================== 校验入口 =====================
+bool OutputVerifier::verify(const QString& outputPath, double expectedVideoDuration,
+                            double expectedAudioDuration)
+{
+    m_tracks.clear();
+    m_errorString.clear();
+
+    Mp4BoxReader reader(outputPath);
+    if (!reader.open()) {
+        return fail(reader.errorString());
+    }
+    const qint64 fileSize = reader.fileSize();
+    if (fileSize == 0) {
+        return fail("输出文件为空");
+    }
+
+    // 1. 顶层盒子：逐个跳读头部，任何盒子都不能越过文件末尾
+    Mp4Box moov;
+    bool hasFtyp = false;
+    bool hasMoov = false;
+    QList<Mp4Box> mdats;
+
+    qint64 offset = 0;
+    while (offset < fileSize) {
+        Mp4Box box;
+        if (!reader.readBoxHeader(offset, box)) {
+            return fail(QString("位置 %1 处的盒子头部无效").arg(offset));
+        }
+        if (box.end() > fileSize) {
+            return fail(QString("%1 盒子被截断，缺少 %2 字节")
+                            .arg(QString::fromLatin1(box.type)).arg(box.end() - fileSize));
+        }
+
+        if (box.type == "ftyp") {
+            hasFtyp = true;
+        } else if (box.type == "moov") {
+            moov = box;
+            hasMoov = true;
+        } else if (box.type == "mdat") {
+            mdats.append(box);
+        }
+        offset = box.end();
+    }
+
+    if (!hasFtyp || !hasMoov) {
+        return fail("缺少 ftyp 或 moov 盒子");
+    }
+
+    // 2. 样本表：每个 chunk 的数据范围都必须落在某个 mdat 内
+    const QByteArray data = reader.readPayload(moov);
+    if (data.isEmpty()) {
+        return fail("无法读取 moov 盒子");
+    }
+    for (const Mp4Box& trak : Mp4BoxReader::childBoxes(data, 0, data.size())) {
+        if (trak.type == "trak" && !checkTrack(data, trak, mdats)) {
+            return false;
+        }
+    }
+    if (m_tracks.isEmpty()) {
+        return fail("输出文件中没有任何轨道");
+    }
+
+    // 3. 时长：与输入相差超过 1 秒或 2% 视为输出不完整
+    auto durationMatches = [](double actual, double expected) {
+        return expected <= 0.0 || qAbs(actual - expected) <= qMax(1.0, expected * 0.02);
+    };
+    for (const OutputTrackSummary& track : m_tracks) {
+        const double expected = (track.handlerType == "vide") ? expectedVideoDuration
+                              : (track.handlerType == "soun") ? expectedAudioDuration
+                                                              : 0.0;
+        if (!durationMatches(track.duration, expected)) {
+            return fail(QString("%1 轨道时长 %2 秒，与输入的 %3 秒不一致")
+                            .arg(QString::fromLatin1(track.handlerType))
+                            .arg(track.duration, 0, 'f', 2).arg(expected, 0, 'f', 2));
+        }
+    }
+
+    return true;
+}
+
+// ===================== 单条轨道检查 =====================
+bool OutputVerifier::checkTrack(const QByteArray& moov, const Mp4Box& trak, const QList<Mp4Box>& mdats)
+{
+    OutputTrackSummary track;
+
+    Mp4Box mdia, mdhd, hdlr, minf, stbl;
+    if (!Mp4BoxReader::findChild(moov, trak.payloadOffset(), trak.end(), "mdia", mdia)
+        || !Mp4BoxReader::findChild(moov, mdia.payloadOffset(), mdia.end(), "mdhd", mdhd)
+        || !Mp4BoxReader::findChild(moov, mdia.payloadOffset(), mdia.end(), "minf", minf)
+        || !Mp4BoxReader::findChild(moov, minf.payloadOffset(), minf.end(), "stbl", stbl)) {
+        return fail("轨道缺少 mdia/mdhd/minf/stbl");
+    }
+    if (Mp4BoxReader::findChild(moov, mdia.payloadOffset(), mdia.end(), "hdlr", hdlr)) {
+        track.handlerType = moov.mid(hdlr.payloadOffset() + 8, 4);
+    }
+
+    const qint64 mdhdPos = mdhd.payloadOffset();
+    const bool mdhdV1 = Mp4BoxReader::readU8(moov, mdhdPos) == 1;
+    const quint32 timescale = Mp4BoxReader::readU32(moov, mdhdPos + (mdhdV1 ? 20 : 12));
+    const quint64 duration = mdhdV1 ? Mp4BoxReader::readU64(moov, mdhdPos + 24)
+                                    : Mp4BoxReader::readU32(moov, mdhdPos + 16);
+    if (timescale > 0) {
+        track.duration = double(duration) / timescale;
+    }
+
+    // stsz：样本大小
+    Mp4Box stsz, stsc, stco;
+    if (!Mp4BoxReader::findChild(moov, stbl.payloadOffset(), stbl.end(), "stsz", stsz)
+        || !Mp4BoxReader::findChild(moov, stbl.payloadOffset(), stbl.end(), "stsc", stsc)) {
+        return fail("轨道缺少 stsz/stsc");
+    }
+    const bool is64 = !Mp4BoxReader::findChild(moov, stbl.payloadOffset(), stbl.end(), "stco", stco)
+                      && Mp4BoxReader::findChild(moov, stbl.payloadOffset(), stbl.end(), "co64", stco);
+    if (stco.type != "stco" && stco.type != "co64") {
+        return fail("轨道缺少 stco/co64");
+    }
+
+    const qint64 stszPos = stsz.payloadOffset();
+    const quint32 uniformSize = Mp4BoxReader::readU32(moov, stszPos + 4);
+    const quint32 sampleCount = Mp4BoxReader::readU32(moov, stszPos + 8);
+    if (uniformSize == 0 && 12 + qint64(sampleCount) * 4 > stsz.payloadSize()) {
+        return fail("stsz 样本表被截断");
+    }
+    track.sampleCount = sampleCount;
+
+    const qint64 stcoPos = stco.payloadOffset();
+    const quint32 chunkCount = Mp4BoxReader::readU32(moov, stcoPos + 4);
+    const int offsetSize = is64 ? 8 : 4;
+    if (8 + qint64(chunkCount) * offsetSize > stco.payloadSize()) {
+        return fail("stco/co64 表被截断");
+    }
+
+    const qint64 stscPos = stsc.payloadOffset();
+    const quint32 stscCount = Mp4BoxReader::readU32(moov, stscPos + 4);
+    if (8 + qint64(stscCount) * 12 > stsc.payloadSize()) {
+        return fail("stsc 表被截断");
+    }
+
+    // 依次计算每个 chunk 的 [offset, offset + size)，检查是否落在 mdat 内
+    quint32 sampleIndex = 0;
+    quint32 stscIndex = 0;
+    quint32 samplesPerChunk = 0;
+    int mdatIndex = 0;
+    for (quint32 chunk = 1; chunk <= chunkCount; ++chunk) {
+        while (stscIndex < stscCount
+               && Mp4BoxReader::readU32(moov, stscPos + 8 + qint64(stscIndex) * 12) <= chunk) {
+            samplesPerChunk = Mp4BoxReader::readU32(moov, stscPos + 8 + qint64(stscIndex) * 12 + 4);
+            ++stscIndex;
+        }
+
+        const qint64 entryPos = stcoPos + 8 + qint64(chunk - 1) * offsetSize;
+        const qint64 chunkOffset = is64 ? qint64(Mp4BoxReader::readU64(moov, entryPos))
+                                        : qint64(Mp4BoxReader::readU32(moov, entryPos));
+
+        qint64 chunkSize = 0;
+        for (quint32 i = 0; i < samplesPerChunk && sampleIndex < sampleCount; ++i, ++sampleIndex) {
+            chunkSize += uniformSize ? uniformSize
+                                     : Mp4BoxReader::readU32(moov, stszPos + 12 + qint64(sampleIndex) * 4);
+        }
+
+        // chunk 偏移基本单调递增，从上一次命中的 mdat 开始查找
+        auto inside = [&](const Mp4Box& mdat) {
+            return chunkOffset >= mdat.payloadOffset() && chunkOffset + chunkSize <= mdat.end();
+        };
+        if (mdatIndex >= mdats.size() || !inside(mdats[mdatIndex])) {
+            mdatIndex = 0;
+            while (mdatIndex < mdats.size() && !inside(mdats[mdatIndex])) {
+                ++mdatIndex;
+            }
+            if (mdatIndex == mdats.size()) {
+                return fail(QString("%1 轨道第 %2 个 chunk 的数据超出 mdat 范围")
+                                .arg(QString::fromLatin1(track.handlerType)).arg(chunk));
+            }
+        }
+    }
+
+    if (sampleIndex < sampleCount) {
+        return fail(QString("%1 轨道有 %2 个样本没有对应的 chunk")
+                        .arg(QString::fromLatin1(track.handlerType)).arg(sampleCount - sampleIndex));
+    }
+
+    m_tracks.append(track);
+    return true;
+}
+
+bool OutputVerifier::fail(const QString& reason)
+{
+    m_errorString = reason;
+    return false;
+}
@@ -0,0 +1,36 @@
+#ifndef OUTPUTVERIFIER_H
+#define OUTPUTVERIFIER_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include "media/mp4boxreader.h"
+
+// 输出文件中一条轨道的摘要
+struct OutputTrackSummary {
+    QByteArray handlerType;   // "vide" / "soun" / "sbtl" ...
+    double duration = 0.0;    // 秒
+    quint32 sampleCount = 0;
+};
+
+// 混流结果校验：只遍历盒子结构和 moov 中的样本表，不解码
+// 检查：顶层盒子不越过文件末尾、样本表引用的数据全部落在 mdat 内、轨道时长与预期一致
+class OutputVerifier
+{
+public:
+    // expected* 为输入的可播放时长（秒），为 0 时不比较
+    bool verify(const QString& outputPath, double expectedVideoDuration = 0.0,
+                double expectedAudioDuration = 0.0);
+
+    const QList<OutputTrackSummary>& tracks() const { return m_tracks; }
+    QString errorString() const { return m_errorString; }
+
+private:
+    bool checkTrack(const QByteArray& moov, const Mp4Box& trak, const QList<Mp4Box>& mdats);
+    bool fail(const QString& reason);
+
+    QList<OutputTrackSummary> m_tracks;
+    QString m_errorString;
+};
+
+#endif // OUTPUTVERIFIER_H
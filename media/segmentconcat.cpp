@@ -0,0 +1,74 @@
+#include "media/segmentconcat.h"
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <algorithm>
+
+namespace {
+
+// 文件名末尾的段号："0.blv" → 0，"video_12.flv" → 12，没有段号时返回 -1
+int segmentNumber(const QString& fileName)
+{
+    static const QRegularExpression pattern(R"((\d+)\.(blv|flv)$)", QRegularExpression::CaseInsensitiveOption);
+    const QRegularExpressionMatch match = pattern.match(fileName);
+    return match.hasMatch() ? match.captured(1).toInt() : -1;
+}
+
+QStringList segmentsIn(const QDir& dir)
+{
+    QList<QPair<int, QString>> numbered;
+    const QStringList files = dir.entryList({"*.blv", "*.flv"}, QDir::Files);
+    for (const QString& fileName : files) {
+        const int number = segmentNumber(fileName);
+        if (number >= 0) {
+            numbered.append({number, dir.filePath(fileName)});
+        }
+    }
+
+    // 按段号排序（字典序会把 10.blv 排在 2.blv 之前）
+    std::sort(numbered.begin(), numbered.end(),
+              [](const QPair<int, QString>& a, const QPair<int, QString>& b) { return a.first < b.first; });
+
+    QStringList segments;
+    for (const auto& entry : numbered) {
+        segments << entry.second;
+    }
+    return segments;
+}
+
+} // namespace
+
+QStringList SegmentConcat::findSegments(const QDir& dir)
+{
+    QStringList segments = segmentsIn(dir);
+    if (!segments.isEmpty()) {
+        return segments;
+    }
+
+    // 安卓客户端把分段放在清晰度子目录中，有多个时取段数最多的一个
+    const QStringList subDirs = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+    for (const QString& subDir : subDirs) {
+        QStringList candidate = segmentsIn(QDir(dir.filePath(subDir)));
+        if (candidate.size() > segments.size()) {
+            segments = candidate;
+        }
+    }
+    return segments;
+}
+
+QByteArray SegmentConcat::buildConcatList(const QStringList& segments)
+{
+    QByteArray list = "ffconcat version 1.0\n";
+    for (const QString& segment : segments) {
+        // 单引号内的单引号写作 '\''
+        QString path = QFileInfo(segment).absoluteFilePath();
+        path.replace("'", R"('\'')");
+        list += "file '" + path.toUtf8() + "'\n";
+    }
+    return list;
+}
+
+QStringList SegmentConcat::inputArgs()
+{
+    // -safe 0 允许绝对路径；列表来自标准输入，需要放行 pipe 协议
+    return {"-f", "concat", "-safe", "0", "-protocol_whitelist", "file,pipe", "-i", "pipe:0"};
+}
@@ -0,0 +1,23 @@
+#ifndef SEGMENTCONCAT_H
+#define SEGMENTCONCAT_H
+
+#include <QByteArray>
+#include <QDir>
+#include <QStringList>
+
+// 旧版缓存的分段FLV（0.blv、1.blv ... 或 xxx_0.flv ...）拼接
+// 使用ffmpeg的concat分离器：列表经标准输入传入，各段时间戳依次平移后流复制到一个输出文件
+class SegmentConcat
+{
+public:
+    // 在目录及其清晰度子目录（如 lua.flv.bili2api.80）中查找分段文件，按段号排序
+    static QStringList findSegments(const QDir& dir);
+
+    // concat分离器的文件列表（写入ffmpeg标准输入）
+    static QByteArray buildConcatList(const QStringList& segments);
+
+    // 读取标准输入列表所需的输入参数（放在其他 -i 之前，作为0号输入）
+    static QStringList inputArgs();
+};
+
+#endif // SEGMENTCONCAT_H
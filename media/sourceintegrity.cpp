@@ -0,0 +1,85 @@
+#include "media/sourceintegrity.h"
+#include "media/fragmentindex.h"
+
+// sidx 声明的时长与实际可播放时长相差超过该值时，视为后续分片缺失
+static const double kDeclaredDurationTolerance = 1.0;
+
+bool SourceIntegrity::isTruncated() const
+{
+    if (!readable || !fragmented) return false;
+    if (missingTailBytes > 0 || completeFragments < totalFragments) return true;
+    // 文件恰好在分片边界处中断时，只能通过 sidx 发现
+    return declaredDuration > 0.0 && playableDuration + kDeclaredDurationTolerance < declaredDuration;
+}
+
+QString SourceIntegrity::summary() const
+{
+    if (!readable) {
+        return QString("无法读取：%1").arg(errorString);
+    }
+    if (!isTruncated()) {
+        return QString();
+    }
+
+    QString text = QString("下载不完整：完整分片 %1/%2，可播放 %3 秒")
+                       .arg(completeFragments).arg(totalFragments)
+                       .arg(playableDuration, 0, 'f', 1);
+    if (declaredDuration > 0.0) {
+        text += QString("（应为 %1 秒）").arg(declaredDuration, 0, 'f', 1);
+    }
+    if (missingTailBytes > 0) {
+        text += QString("，缺少 %1 字节").arg(missingTailBytes);
+    }
+    return text;
+}
+
+SourceIntegrity SourceIntegrity::check(const QString& filePath)
+{
+    SourceIntegrity result;
+
+    FragmentIndex index;
+    if (!index.build(filePath)) {
+        result.errorString = index.errorString();
+        return result;
+    }
+
+    result.readable = true;
+    result.fragmented = index.isFragmented();
+    result.totalFragments = index.fragments().size();
+    result.completeFragments = index.completeFragmentCount();
+    result.missingTailBytes = index.missingTailBytes();
+    result.playableDuration = index.playableDuration();
+    result.declaredDuration = index.declaredDuration();
+    result.errorString = index.errorString();
+
+    if (index.timescale() > 0) {
+        quint64 end = 0;
+        const int completeCount = result.completeFragments;
+        result.fragmentEnds.reserve(completeCount);
+        for (int i = 0; i < completeCount; ++i) {
+            end += index.fragments()[i].duration;
+            result.fragmentEnds.append(double(end) / index.timescale());
+        }
+    }
+    return result;
+}
+
+double SourceIntegrity::salvageDuration(const SourceIntegrity& video, const SourceIntegrity& audio)
+{
+    // 视频分片以关键帧开始，截取点只能落在视频分片边界上；音频帧很短，可在任意位置截断
+    if (!video.fragmented || video.fragmentEnds.isEmpty()) {
+        return 0.0;
+    }
+
+    double limit = video.playableDuration;
+    if (audio.fragmented) {
+        limit = qMin(limit, audio.playableDuration);
+    }
+
+    for (int i = video.fragmentEnds.size() - 1; i >= 0; --i) {
+        if (video.fragmentEnds[i] <= limit + 0.001) {
+            return video.fragmentEnds[i];
+        }
+    }
+    return 0.0;
+}
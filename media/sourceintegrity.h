@@ -0,0 +1,29 @@
+#ifndef SOURCEINTEGRITY_H
+#define SOURCEINTEGRITY_H
+
+#include <QList>
+#include <QString>
+
+// 单个输入文件（m4s）的完整性检查结果
+struct SourceIntegrity {
+    bool readable = false;         // 文件可以打开且能识别
+    bool fragmented = false;       // 是否为分片MP4（非分片文件不做分片检查）
+    int totalFragments = 0;        // 已发现的分片数（含不完整的最后一个）
+    int completeFragments = 0;     // 从头开始连续完整的分片数
+    qint64 missingTailBytes = 0;   // 最后一个盒子缺少的字节数
+    double playableDuration = 0.0; // 连续完整分片的时长（秒）
+    double declaredDuration = 0.0; // sidx 声明的时长（秒），未知为0
+    QList<double> fragmentEnds;    // 每个完整分片结束时刻（秒，相对文件开头）
+    QString errorString;
+
+    bool isTruncated() const;
+    QString summary() const;       // 供界面和日志显示的简短描述
+
+    // 只跳读盒子头部（以及很小的 moov/moof/sidx），与文件大小无关
+    static SourceIntegrity check(const QString& filePath);
+
+    // 截断时可挽救的时长：音视频都完整的最后一个视频分片边界（秒），无法挽救时返回0
+    static double salvageDuration(const SourceIntegrity& video, const SourceIntegrity& audio);
+};
+
+#endif // SOURCEINTEGRITY_H
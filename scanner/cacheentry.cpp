@@ -0,0 +1,20 @@
+#include "scanner/cacheentry.h"
+
+QString CacheEntry::qualityName(int qualityId)
+{
+    switch (qualityId) {
+    case 6:   return "240P";
+    case 16:  return "360P";
+    case 32:  return "480P";
+    case 64:  return "720P";
+    case 74:  return "720P60";
+    case 80:  return "1080P";
+    case 112: return "1080P+";
+    case 116: return "1080P60";
+    case 120: return "4K";
+    case 125: return "HDR";
+    case 126: return "杜比视界";
+    case 127: return "8K";
+    default:  return qualityId > 0 ? QString::number(qualityId) : QString();
+    }
+}
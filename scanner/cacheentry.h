@@ -0,0 +1,38 @@
+#ifndef CACHEENTRY_H
+#define CACHEENTRY_H
+
+#include <QDateTime>
+#include <QString>
+#include <QStringList>
+
+// 扫描缓存目录得到的一个视频（一个分P/剧集的一种清晰度）
+struct CacheEntry {
+    QString layout;              // 识别出的缓存布局名称
+    QString directory;           // 该视频所在目录
+    QString title;
+    QString videoPath;
+    QString audioPath;
+    QStringList segmentFiles;    // 旧版分段FLV
+    QStringList subtitleFiles;   // CC字幕JSON
+
+    QString upName;
+    QString upUid;
+    QString series;
+    QString avNumber;
+
+    int qualityId = 0;           // B站清晰度代码（qn），如 80=1080P、120=4K
+    int videoCodecId = 0;        // 7=AVC、12=HEVC、13=AV1，未知为0
+    int width = 0;
+    int height = 0;
+    qint64 cid = 0;              // 分P/剧集ID，同一内容的不同清晰度相同
+    int page = 0;
+    qint64 totalSize = 0;        // 字节
+    double duration = 0.0;       // 秒
+    QDateTime createTime;
+    QString fingerprint;         // 抽样内容指纹（去重时计算）
+
+    QString qualityName() const { return qualityName(qualityId); }
+    static QString qualityName(int qualityId);
+};
+
+#endif // CACHEENTRY_H
@@ -0,0 +1,356 @@
+#include "scanner/cachelayout.h"
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include "media/ccsubtitleconverter.h"
+#include "media/segmentconcat.h"
+
+namespace {
+
+QJsonObject readJsonObject(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QJsonObject();
+    }
+    return QJsonDocument::fromJson(file.readAll()).object();
+}
+
+// 数字ID在不同客户端中既可能是数字也可能是字符串
+QString idString(const QJsonValue& value)
+{
+    if (value.isString()) return value.toString();
+    if (value.isDouble()) return QString::number(qint64(value.toDouble()));
+    return QString();
+}
+
+// 多个键名中第一个非空的字符串值
+QString firstString(const QJsonObject& json, const QStringList& keys)
+{
+    for (const QString& key : keys) {
+        const QString value = json.value(key).toString();
+        if (!value.isEmpty()) return value;
+    }
+    return QString();
+}
+
+// 清晰度目录名末尾的数字，如 "80"、"lua.flv.bili2api.80" → 80
+int trailingNumber(const QString& text)
+{
+    static const QRegularExpression pattern(R"((\d+)$)");
+    const QRegularExpressionMatch match = pattern.match(text);
+    return match.hasMatch() ? match.captured(1).toInt() : 0;
+}
+
+// 没有 video.m4s 时使用分段FLV（单段直接作为视频文件）
+bool assignMedia(const QDir& mediaDir, CacheEntry& entry)
+{
+    const QString videoPath = mediaDir.filePath("video.m4s");
+    const QString audioPath = mediaDir.filePath("audio.m4s");
+    if (QFile::exists(videoPath)) {
+        entry.videoPath = videoPath;
+        if (QFile::exists(audioPath)) entry.audioPath = audioPath;
+        return true;
+    }
+
+    const QStringList segments = SegmentConcat::findSegments(mediaDir);
+    if (segments.isEmpty()) {
+        return false;
+    }
+    // 单段FLV也走分段路径，混流时才会映射FLV自身的音频
+    entry.videoPath = segments.first();
+    entry.segmentFiles = segments;
+    return true;
+}
+
+} // namespace
+
+// ===================== 公共辅助 =====================
+bool CacheLayout::containsFile(const QDir& root, const QStringList& nameFilters, int maxDepth)
+{
+    // 逐层查找，命中即返回；不递归整棵树
+    QList<QString> level{root.absolutePath()};
+    for (int depth = 0; depth <= maxDepth && !level.isEmpty(); ++depth) {
+        QList<QString> next;
+        for (const QString& path : level) {
+            QDir dir(path);
+            if (!dir.entryList(nameFilters, QDir::Files | QDir::Hidden).isEmpty()) {
+                return true;
+            }
+            for (const QString& sub : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+                next.append(dir.filePath(sub));
+            }
+        }
+        level = next;
+    }
+    return false;
+}
+
+QStringList CacheLayout::findCcSubtitles(const QDir& dir)
+{
+    QStringList subtitlePaths;
+    for (const QString& fileName : dir.entryList({"*.json"}, QDir::Files, QDir::Name)) {
+        const QString path = dir.filePath(fileName);
+        if (CcSubtitleConverter::isCcSubtitleFile(path)) {
+            subtitlePaths << path;
+        }
+    }
+    return subtitlePaths;
+}
+
+qint64 CacheLayout::fileSize(const QString& path)
+{
+    return path.isEmpty() ? 0 : QFileInfo(path).size();
+}
+
+void CacheLayout::fillSizeIfUnknown(CacheEntry& entry)
+{
+    if (entry.totalSize > 0) return;
+    if (!entry.segmentFiles.isEmpty()) {
+        for (const QString& segment : entry.segmentFiles) entry.totalSize += fileSize(segment);
+    } else {
+        entry.totalSize = fileSize(entry.videoPath) + fileSize(entry.audioPath);
+    }
+}
+
+// ===================== 安卓客户端 =====================
+bool AndroidCacheLayout::detect(const QDir& root) const
+{
+    return containsFile(root, {"entry.json"}, 3);
+}
+
+QList<CacheEntry> AndroidCacheLayout::scan(const QDir& root) const
+{
+    QList<CacheEntry> entries;
+    QDirIterator it(root.absolutePath(), {"entry.json"}, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString entryPath = it.next();
+        const QJsonObject json = readJsonObject(entryPath);
+        if (json.isEmpty()) continue;
+
+        const QDir entryDir = QFileInfo(entryPath).absoluteDir();
+        CacheEntry entry;
+        entry.layout = name();
+        entry.directory = entryDir.absolutePath();
+
+        // 番剧使用 ep，普通视频使用 page_data
+        const QString title = json.value("title").toString();
+        const QJsonObject ep = json.value("ep").toObject();
+        const QJsonObject pageData = json.value("page_data").toObject();
+        if (!ep.isEmpty()) {
+            const QString episode = ep.value("index").toString();
+            const QString episodeTitle = ep.value("index_title").toString();
+            entry.series = title;
+            entry.title = QStringList{title, episode, episodeTitle}.join(' ').simplified();
+            entry.cid = qint64(json.value("source").toObject().value("cid").toDouble());
+            entry.page = episode.toInt();
+            entry.avNumber = ep.value("bvid").toString();
+            if (entry.avNumber.isEmpty() && ep.value("av_id").toDouble() > 0) {
+                entry.avNumber = "av" + idString(ep.value("av_id"));
+            }
+        } else {
+            const QString part = pageData.value("part").toString();
+            entry.title = (part.isEmpty() || part == title) ? title : title + " - " + part;
+            entry.cid = qint64(pageData.value("cid").toDouble());
+            entry.page = pageData.value("page").toInt();
+            entry.avNumber = json.value("bvid").toString();
+            if (entry.avNumber.isEmpty() && json.value("avid").toDouble() > 0) {
+                entry.avNumber = "av" + idString(json.value("avid"));
+            }
+        }
+        if (entry.title.isEmpty()) entry.title = entryDir.dirName();
+
+        entry.upName = json.value("owner_name").toString();
+        entry.upUid = idString(json.value("owner_id"));
+        entry.duration = json.value("total_time_milli").toDouble() / 1000.0;
+        if (json.value("time_create_stamp").toDouble() > 0) {
+            entry.createTime = QDateTime::fromMSecsSinceEpoch(qint64(json.value("time_create_stamp").toDouble()));
+        }
+        entry.subtitleFiles = findCcSubtitles(entryDir);
+
+        // 每个清晰度子目录是一个版本（type_tag 只指向最后一次下载的那个），由扫描器按策略挑选
+        const QString typeTag = json.value("type_tag").toString();
+        for (const QString& sub : entryDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+            const QDir mediaDir(entryDir.filePath(sub));
+            CacheEntry rendition = entry;
+            if (!assignMedia(mediaDir, rendition)) continue;
+            rendition.qualityId = trailingNumber(sub);
+
+            // index.json 中有编码和分辨率
+            const QJsonArray videoStreams = readJsonObject(mediaDir.filePath("index.json")).value("video").toArray();
+            const QJsonObject video = videoStreams.isEmpty() ? QJsonObject() : videoStreams.at(0).toObject();
+            rendition.videoCodecId = video.value("codecid").toInt();
+            rendition.width = video.value("width").toInt();
+            rendition.height = video.value("height").toInt();
+            if (video.value("id").toInt() > 0) rendition.qualityId = video.value("id").toInt();
+            if (rendition.width == 0 && sub == typeTag) {
+                rendition.width = pageData.value("width").toInt();
+                rendition.height = pageData.value("height").toInt();
+            }
+
+            // total_bytes 只对应 type_tag 指向的版本
+            if (sub == typeTag) rendition.totalSize = qint64(json.value("total_bytes").toDouble());
+            fillSizeIfUnknown(rendition);
+
+            entries.append(rendition);
+        }
+    }
+    return entries;
+}
+
+// ===================== PC客户端 =====================
+bool PcClientCacheLayout::detect(const QDir& root) const
+{
+    return containsFile(root, {"videoInfo.json", ".videoInfo"}, 2);
+}
+
+QList<CacheEntry> PcClientCacheLayout::scan(const QDir& root) const
+{
+    // 音频流ID：30216/30232/30280 为AAC，30250 为杜比全景声，30251 为无损
+    static const QRegularExpression audioStream(R"(-302(16|32|80|50|51)\.m4s$)");
+
+    QList<CacheEntry> entries;
+    QDirIterator it(root.absolutePath(), {"videoInfo.json", ".videoInfo"},
+                    QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString infoPath = it.next();
+        const QJsonObject json = readJsonObject(infoPath);
+        const QDir dir = QFileInfo(infoPath).absoluteDir();
+
+        CacheEntry entry;
+        entry.layout = name();
+        entry.directory = dir.absolutePath();
+
+        // 目录中通常只有一路视频和一路音频，有多路时取最大的
+        for (const QString& fileName : dir.entryList({"*.m4s"}, QDir::Files)) {
+            const QString path = dir.filePath(fileName);
+            QString& target = audioStream.match(fileName).hasMatch() ? entry.audioPath : entry.videoPath;
+            if (target.isEmpty() || fileSize(path) > fileSize(target)) {
+                target = path;
+            }
+        }
+        if (entry.videoPath.isEmpty()) continue;
+
+        const QString title = json.value("title").toString();
+        const QString groupTitle = json.value("groupTitle").toString();
+        entry.series = groupTitle;
+        entry.title = (groupTitle.isEmpty() || groupTitle == title) ? title : groupTitle + " - " + title;
+        if (entry.title.isEmpty()) entry.title = dir.dirName();
+
+        entry.upName = json.value("uname").toString();
+        entry.upUid = idString(json.value("uid"));
+        entry.avNumber = json.value("bvid").toString();
+        if (entry.avNumber.isEmpty() && json.value("aid").toDouble() > 0) {
+            entry.avNumber = "av" + idString(json.value("aid"));
+        }
+        entry.cid = qint64(json.value("cid").toDouble());
+        entry.page = json.value("p").toInt();
+        entry.qualityId = json.value("qn").toInt();
+        entry.videoCodecId = json.value("codecid").toInt();
+        entry.duration = json.value("duration").toDouble();
+        entry.createTime = QFileInfo(infoPath).lastModified();
+        entry.subtitleFiles = findCcSubtitles(dir);
+        fillSizeIfUnknown(entry);
+
+        entries.append(entry);
+    }
+    return entries;
+}
+
+// ===================== UWP客户端 =====================
+bool UwpCacheLayout::detect(const QDir& root) const
+{
+    return containsFile(root, {"*.info"}, 3);
+}
+
+QList<CacheEntry> UwpCacheLayout::scan(const QDir& root) const
+{
+    QList<CacheEntry> entries;
+    QDirIterator it(root.absolutePath(), {"*.info"}, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString infoPath = it.next();
+        const QJsonObject json = readJsonObject(infoPath);
+        if (json.isEmpty()) continue;
+        const QDir dir = QFileInfo(infoPath).absoluteDir();
+
+        CacheEntry entry;
+        entry.layout = name();
+        entry.directory = dir.absolutePath();
+
+        // 音视频分离时文件名中带有 video/audio，否则为单个或分段的完整文件
+        for (const QString& fileName : dir.entryList({"*.m4s", "*.mp4"}, QDir::Files)) {
+            if (fileName.contains("audio", Qt::CaseInsensitive)) {
+                entry.audioPath = dir.filePath(fileName);
+            } else if (fileName.contains("video", Qt::CaseInsensitive) || entry.videoPath.isEmpty()) {
+                entry.videoPath = dir.filePath(fileName);
+            }
+        }
+        if (entry.videoPath.isEmpty() && !assignMedia(dir, entry)) continue;
+
+        // 不同版本的字段名不完全一致
+        const QString title = firstString(json, {"Title", "title"});
+        const QString part = firstString(json, {"PartName", "PartTitle", "part"});
+        entry.series = title;
+        entry.title = (part.isEmpty() || part == title) ? title : title + " - " + part;
+        if (entry.title.isEmpty()) entry.title = dir.dirName();
+        entry.upName = firstString(json, {"UpName", "OwnerName", "Uploader"});
+        entry.avNumber = firstString(json, {"Bvid", "BvId"});
+        if (entry.avNumber.isEmpty()) {
+            const QString aid = idString(json.value("Aid"));
+            if (!aid.isEmpty()) entry.avNumber = "av" + aid;
+        }
+        entry.cid = idString(json.value("Cid")).toLongLong();
+        entry.createTime = QFileInfo(infoPath).lastModified();
+        entry.subtitleFiles = findCcSubtitles(dir);
+        fillSizeIfUnknown(entry);
+
+        entries.append(entry);
+    }
+    return entries;
+}
+
+// ===================== 通用 =====================
+bool GenericCacheLayout::detect(const QDir& root) const
+{
+    Q_UNUSED(root);
+    return true;
+}
+
+QList<CacheEntry> GenericCacheLayout::scan(const QDir& root) const
+{
+    QList<CacheEntry> entries;
+    QStringList dirs{root.absolutePath()};
+    QDirIterator it(root.absolutePath(), QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        dirs << it.next();
+    }
+
+    for (const QString& path : dirs) {
+        const QDir dir(path);
+        CacheEntry entry;
+        entry.layout = name();
+        entry.directory = path;
+
+        // 分段文件只在其所在目录计一次，避免父目录重复命中
+        const bool hasMedia = QFile::exists(dir.filePath("video.m4s"))
+                              || !dir.entryList({"*.blv", "*.flv"}, QDir::Files).isEmpty();
+        if (!hasMedia || !assignMedia(dir, entry)) continue;
+
+        // 清晰度目录（纯数字或 lua.*）以上一级目录名为标题
+        QString title = dir.dirName();
+        if (trailingNumber(title) > 0 && (title.startsWith("lua.") || title.toInt() > 0)) {
+            title = QFileInfo(path).dir().dirName();
+            entry.qualityId = trailingNumber(dir.dirName());
+        }
+        entry.title = title;
+        entry.subtitleFiles = findCcSubtitles(dir);
+        fillSizeIfUnknown(entry);
+
+        entries.append(entry);
+    }
+    return entries;
+}
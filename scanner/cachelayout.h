@@ -0,0 +1,65 @@
+#ifndef CACHELAYOUT_H
+#define CACHELAYOUT_H
+
+#include <QDir>
+#include <QList>
+#include <QString>
+#include "scanner/cacheentry.h"
+
+// 一种缓存目录布局的识别与扫描
+// 扫描器对每个根目录只调用一次 detect()，之后使用识别出的布局直接扫描
+class CacheLayout
+{
+public:
+    virtual ~CacheLayout() = default;
+
+    virtual QString name() const = 0;
+    // 根据少量特征文件判断根目录是否属于该布局
+    virtual bool detect(const QDir& root) const = 0;
+    virtual QList<CacheEntry> scan(const QDir& root) const = 0;
+
+protected:
+    // 在 maxDepth 层以内查找第一个匹配 nameFilters 的文件所在目录
+    static bool containsFile(const QDir& root, const QStringList& nameFilters, int maxDepth);
+    static QStringList findCcSubtitles(const QDir& dir);
+    static qint64 fileSize(const QString& path);
+    static void fillSizeIfUnknown(CacheEntry& entry);
+};
+
+// 安卓客户端：download/<avid>/<cid或分P>/entry.json + <清晰度>/video.m4s、audio.m4s（或分段blv）
+class AndroidCacheLayout : public CacheLayout
+{
+public:
+    QString name() const override { return "Android"; }
+    bool detect(const QDir& root) const override;
+    QList<CacheEntry> scan(const QDir& root) const override;
+};
+
+// PC客户端：<cid>/videoInfo.json + <cid>-1-<流ID>.m4s，m4s 开头带有填充字节
+class PcClientCacheLayout : public CacheLayout
+{
+public:
+    QString name() const override { return "PC"; }
+    bool detect(const QDir& root) const override;
+    QList<CacheEntry> scan(const QDir& root) const override;
+};
+
+// UWP客户端：<avid或ssid>/<分P>/*.info + 音视频文件
+class UwpCacheLayout : public CacheLayout
+{
+public:
+    QString name() const override { return "UWP"; }
+    bool detect(const QDir& root) const override;
+    QList<CacheEntry> scan(const QDir& root) const override;
+};
+
+// 通用：任意包含 video.m4s/audio.m4s 或分段FLV 的目录，标题取目录名
+class GenericCacheLayout : public CacheLayout
+{
+public:
+    QString name() const override { return "通用"; }
+    bool detect(const QDir& root) const override;
+    QList<CacheEntry> scan(const QDir& root) const override;
+};
+
+#endif // CACHELAYOUT_H
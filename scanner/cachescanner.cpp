@@ -0,0 +1,47 @@
+#include "scanner/cachescanner.h"
+#include "managers/applog.h"
+#include <QDir>
+
+CacheScanner::CacheScanner()
+{
+    // 通用布局总能命中，必须最后注册
+    registerLayout(std::make_unique<AndroidCacheLayout>());
+    registerLayout(std::make_unique<PcClientCacheLayout>());
+    registerLayout(std::make_unique<UwpCacheLayout>());
+    registerLayout(std::make_unique<GenericCacheLayout>());
+}
+
+void CacheScanner::setRenditionPolicy(RenditionPolicy policy, int preferredCodecId)
+{
+    m_selector = RenditionSelector(policy, preferredCodecId);
+}
+
+void CacheScanner::registerLayout(std::unique_ptr<CacheLayout> layout)
+{
+    // 后注册的布局插在通用布局之前
+    if (!m_layouts.empty() && dynamic_cast<GenericCacheLayout*>(m_layouts.back().get())) {
+        m_layouts.insert(m_layouts.end() - 1, std::move(layout));
+    } else {
+        m_layouts.push_back(std::move(layout));
+    }
+}
+
+QList<CacheEntry> CacheScanner::scan(const QString& rootPath)
+{
+    m_detectedLayout.clear();
+
+    const QDir root(rootPath);
+    if (!root.exists()) {
+        qCWarning(lcScan) << "缓存目录不存在:" << rootPath;
+        return {};
+    }
+
+    for (const auto& layout : m_layouts) {
+        if (layout->detect(root)) {
+            m_detectedLayout = layout->name();
+            qCDebug(lcScan) << "识别到缓存布局:" << m_detectedLayout << rootPath;
+            return m_selector.select(layout->scan(root));
+        }
+    }
+    return {};
+}
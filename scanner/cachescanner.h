@@ -0,0 +1,34 @@
+#ifndef CACHESCANNER_H
+#define CACHESCANNER_H
+
+#include <memory>
+#include <vector>
+#include <QList>
+#include <QString>
+#include "scanner/cacheentry.h"
+#include "scanner/cachelayout.h"
+#include "scanner/renditionselector.h"
+
+// 整个缓存目录的扫描器：按注册顺序识别布局，命中第一个后只用该布局扫描
+// 不访问界面对象，可以在线程池中运行
+class CacheScanner
+{
+public:
+    CacheScanner();  // 注册内置布局（安卓、PC、UWP、通用）
+
+    void registerLayout(std::unique_ptr<CacheLayout> layout);
+
+    // 同一内容的多个清晰度版本按策略只保留一个（默认清晰度最高）
+    void setRenditionPolicy(RenditionPolicy policy, int preferredCodecId);
+
+    QList<CacheEntry> scan(const QString& rootPath);
+    QString detectedLayout() const { return m_detectedLayout; }  // 最近一次扫描识别出的布局
+    int skippedRenditions() const { return m_selector.skippedCount(); }
+
+private:
+    std::vector<std::unique_ptr<CacheLayout>> m_layouts;
+    QString m_detectedLayout;
+    RenditionSelector m_selector;
+};
+
+#endif // CACHESCANNER_H
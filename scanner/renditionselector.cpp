@@ -0,0 +1,77 @@
+#include "scanner/renditionselector.h"
+#include <QFileInfo>
+#include <QHash>
+
+RenditionSelector::RenditionSelector(RenditionPolicy policy, int preferredCodecId)
+    : m_policy(policy), m_preferredCodecId(preferredCodecId)
+{
+}
+
+QString RenditionSelector::groupKey(const CacheEntry& entry)
+{
+    if (entry.cid > 0) {
+        return "cid:" + QString::number(entry.cid);
+    }
+    if (!entry.avNumber.isEmpty()) {
+        return entry.avNumber + "/p" + QString::number(entry.page);
+    }
+    // 没有ID时，同一目录下的清晰度子目录视为同一内容：
+    // 清晰度目录（如 .../80、.../112）本身按上一级目录分组
+    if (entry.qualityId > 0) {
+        return "dir:" + QFileInfo(entry.directory).dir().absolutePath();
+    }
+    return "dir:" + QFileInfo(entry.directory).absoluteFilePath();
+}
+
+QList<CacheEntry> RenditionSelector::select(const QList<CacheEntry>& entries)
+{
+    m_skippedCount = 0;
+    if (m_policy == RenditionKeepAll) {
+        return entries;
+    }
+
+    // 保持首次出现的顺序，每组记录当前最优项的位置
+    QList<CacheEntry> selected;
+    QHash<QString, int> positions;
+    for (const CacheEntry& entry : entries) {
+        const QString key = groupKey(entry);
+        auto it = positions.constFind(key);
+        if (it == positions.constEnd()) {
+            positions.insert(key, selected.size());
+            selected.append(entry);
+            continue;
+        }
+
+        ++m_skippedCount;
+        if (isBetter(entry, selected[it.value()])) {
+            selected[it.value()] = entry;
+        }
+    }
+    return selected;
+}
+
+bool RenditionSelector::isBetter(const CacheEntry& candidate, const CacheEntry& current) const
+{
+    if (m_policy == RenditionSmallestSize) {
+        return candidate.totalSize < current.totalSize;
+    }
+
+    if (m_policy == RenditionPreferredCodec) {
+        const bool candidateMatches = candidate.videoCodecId == m_preferredCodecId;
+        const bool currentMatches = current.videoCodecId == m_preferredCodecId;
+        if (candidateMatches != currentMatches) {
+            return candidateMatches;
+        }
+    }
+
+    // 清晰度代码越大越好，相同时比较分辨率，再相同时取较小的文件
+    if (candidate.qualityId != current.qualityId) {
+        return candidate.qualityId > current.qualityId;
+    }
+    const qint64 candidatePixels = qint64(candidate.width) * candidate.height;
+    const qint64 currentPixels = qint64(current.width) * current.height;
+    if (candidatePixels != currentPixels) {
+        return candidatePixels > currentPixels;
+    }
+    return candidate.totalSize < current.totalSize;
+}
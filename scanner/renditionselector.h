@@ -0,0 +1,29 @@
+#ifndef RENDITIONSELECTOR_H
+#define RENDITIONSELECTOR_H
+
+#include <QList>
+#include <QString>
+#include "delegates/renditionpolicy.h"
+#include "scanner/cacheentry.h"
+
+// 按分P/剧集分组，每组按策略只保留一个版本（只比较扫描得到的元数据，不探测文件）
+class RenditionSelector
+{
+public:
+    RenditionSelector(RenditionPolicy policy = RenditionHighestQuality, int preferredCodecId = 7);
+
+    QList<CacheEntry> select(const QList<CacheEntry>& entries);
+    int skippedCount() const { return m_skippedCount; }  // 最近一次被舍弃的版本数
+
+    // 分组依据：cid > av号+分P > 目录
+    static QString groupKey(const CacheEntry& entry);
+
+private:
+    bool isBetter(const CacheEntry& candidate, const CacheEntry& current) const;
+
+    RenditionPolicy m_policy;
+    int m_preferredCodecId;
+    int m_skippedCount = 0;
+};
+
+#endif // RENDITIONSELECTOR_H
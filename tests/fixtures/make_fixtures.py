@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+# 生成 tests/fixtures 下的分片MP4测试文件（结果已提交，修改后重新运行本脚本）
+# 轨道时间刻度 1000，每个分片 2 个样本、每个样本 1000（即每个分片 2 秒）
+import os
+import struct
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+
+def box(kind, payload):
+    return struct.pack(">I", 8 + len(payload)) + kind + payload
+
+
+def full(version, flags):
+    return struct.pack(">I", (version << 24) | flags)
+
+
+def moov():
+    tkhd = box(b"tkhd", full(0, 3) + bytes(76) + struct.pack(">II", 1920 << 16, 1080 << 16))
+    mdhd = box(b"mdhd", full(0, 0) + struct.pack(">IIIII", 0, 0, 1000, 0, 0))
+    hdlr = box(b"hdlr", full(0, 0) + struct.pack(">I", 0) + b"vide" + bytes(12) + b"\0")
+    mdia = box(b"mdia", mdhd + hdlr)
+    trak = box(b"trak", tkhd + mdia)
+    trex = box(b"trex", full(0, 0) + struct.pack(">IIIII", 1, 1, 1000, 0, 0))
+    mvex = box(b"mvex", trex)
+    return box(b"moov", trak + mvex)
+
+
+def sidx(durations):
+    payload = full(0, 0) + struct.pack(">IIII", 1, 1000, 0, 0) + struct.pack(">HH", 0, len(durations))
+    for duration in durations:
+        payload += struct.pack(">III", 0, duration, 0x90000000)
+    return box(b"sidx", payload)
+
+
+def fragment(sequence, start, sample_count=2):
+    # trun 标志 0x301：data_offset + 每样本时长 + 每样本大小
+    entries = b"".join(struct.pack(">II", 1000, 4) for _ in range(2))
+    trun = box(b"trun", full(0, 0x301) + struct.pack(">Ii", sample_count, 0) + entries)
+    tfhd = box(b"tfhd", full(0, 0x020000) + struct.pack(">I", 1))
+    tfdt = box(b"tfdt", full(0, 0) + struct.pack(">I", start))
+    traf = box(b"traf", tfhd + tfdt + trun)
+    moof = box(b"moof", box(b"mfhd", full(0, 0) + struct.pack(">I", sequence)) + traf)
+    return moof, box(b"mdat", bytes(8))
+
+
+def write(name, data):
+    with open(os.path.join(HERE, name), "wb") as f:
+        f.write(data)
+
+
+def main():
+    header = box(b"ftyp", b"iso5" + struct.pack(">I", 512) + b"iso5dash") + moov()
+    moof1, mdat1 = fragment(1, 0)
+    moof2, mdat2 = fragment(2, 2000)
+
+    complete = header + sidx([2000, 2000]) + moof1 + mdat1 + moof2 + mdat2
+    write("complete.m4s", complete)
+    # 最后一个 mdat 少 6 字节
+    write("truncated_mdat.m4s", complete[:-6])
+    # 在最后一个 moof 中间中断
+    write("truncated_moof.m4s", complete[:len(complete) - len(mdat2) - len(moof2) // 2])
+
+    # 第二个分片的 trun 声明的样本数远超盒子长度
+    bad_moof, bad_mdat = fragment(2, 2000, sample_count=0x40000000)
+    write("trun_overflow.m4s", header + sidx([2000, 2000]) + moof1 + mdat1 + bad_moof + bad_mdat)
+
+    # 恰好在分片边界处中断：盒子都完整，只有 sidx 声明的 10 秒能说明后续分片缺失
+    write("sidx_mismatch.m4s", header + sidx([2000] * 5) + moof1 + mdat1 + moof2 + mdat2)
+
+
+if __name__ == "__main__":
+    main()
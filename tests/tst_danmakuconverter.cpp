@@ -0,0 +1,83 @@
+#include <QtTest>
+#include "media/danmakuconverter.h"
+
+// 默认画布 1920x1080、字号 48：行高 52，ASCII 字符宽 24
+class TestDanmakuConverter : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QString fixture() { return QFINDTESTDATA("fixtures/danmaku_layout.xml"); }
+    // 按出现顺序取出 Dialogue 行
+    static QStringList dialogues(const QByteArray& ass);
+
+private slots:
+    void loadSkipsAdvancedComments();
+    void scrollTopBottomLayout();
+    void dropsWhenNoRowIsFree();
+    void countAndDetect();
+};
+
+QStringList TestDanmakuConverter::dialogues(const QByteArray& ass)
+{
+    QStringList lines;
+    for (const QString& line : QString::fromUtf8(ass).split('\n')) {
+        if (line.startsWith("Dialogue:")) lines << line;
+    }
+    return lines;
+}
+
+void TestDanmakuConverter::loadSkipsAdvancedComments()
+{
+    DanmakuConverter converter;
+    QVERIFY2(converter.load(fixture()), qPrintable(converter.errorString()));
+    // 高级弹幕(模式7)不转换
+    QCOMPARE(converter.commentCount(), 6);
+}
+
+void TestDanmakuConverter::scrollTopBottomLayout()
+{
+    DanmakuConverter converter;
+    QVERIFY(converter.load(fixture()));
+    const QStringList lines = dialogues(converter.toAss());
+    QCOMPARE(converter.droppedCount(), 0);
+
+    // 按时间排序，同一时刻保持XML中的顺序
+    const QStringList expected = {
+        // 同时出现的两条滚动弹幕分到第 0、1 行
+        R"(Dialogue: 2,0:00:00.00,0:00:08.00,Danmaku,,0,0,0,,{\an7\move(1920,0,-192,0)}scroll-a)",
+        R"(Dialogue: 2,0:00:00.00,0:00:08.00,Danmaku,,0,0,0,,{\an7\move(1920,52,-192,52)}scroll-b)",
+        // 顶部弹幕自上而下，颜色按 BGR 写入
+        R"(Dialogue: 2,0:00:00.00,0:00:04.00,Danmaku,,0,0,0,,{\an8\pos(960,0)}top-a)",
+        R"(Dialogue: 2,0:00:00.00,0:00:04.00,Danmaku,,0,0,0,,{\an8\pos(960,52)\c&H0000FF&}top-b)",
+        // 底部弹幕从画布底边开始
+        R"(Dialogue: 2,0:00:00.00,0:00:04.00,Danmaku,,0,0,0,,{\an2\pos(960,1080)}bottom)",
+        // 逆向滚动：第 0 行上一条已完全进入屏幕，且不会追上其尾部
+        R"(Dialogue: 2,0:00:01.00,0:00:09.00,Danmaku,,0,0,0,,{\an7\move(-168,0,1920,0)}reverse)",
+    };
+    QCOMPARE(lines, expected);
+}
+
+void TestDanmakuConverter::dropsWhenNoRowIsFree()
+{
+    // 只有一行时，同时出现的第二条滚动弹幕和第二条顶部弹幕无处放置
+    DanmakuConverter::Options options;
+    options.height = 52;
+    DanmakuConverter converter(options);
+    QVERIFY(converter.load(fixture()));
+    const QStringList lines = dialogues(converter.toAss());
+    QCOMPARE(converter.droppedCount(), 2);
+    QCOMPARE(lines.size(), 4);
+    QVERIFY(!lines.join('\n').contains("scroll-b"));
+    QVERIFY(!lines.join('\n').contains("top-b"));
+}
+
+void TestDanmakuConverter::countAndDetect()
+{
+    QVERIFY(DanmakuConverter::isDanmakuXml(fixture()));
+    // 只数 <d> 元素，包括不转换的高级弹幕
+    QCOMPARE(DanmakuConverter::countComments(fixture()), 7);
+}
+
+QTEST_APPLESS_MAIN(TestDanmakuConverter)
+#include "tst_danmakuconverter.moc"
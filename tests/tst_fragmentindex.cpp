@@ -0,0 +1,112 @@
+#include <QtTest>
+#include "media/fragmentindex.h"
+#include "media/sourceintegrity.h"
+
+// 夹具由 fixtures/make_fixtures.py 生成：时间刻度 1000，每个分片 2 个样本、共 2 秒
+class TestFragmentIndex : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QString fixture(const char* name) { return QFINDTESTDATA(QString("fixtures/") + name); }
+
+private slots:
+    void completeFile();
+    void truncatedLastMdat();
+    void truncatedLastMoof();
+    void trunCountOverflow();
+    void sidxDurationMismatch();
+    void salvageStopsAtCompleteFragment();
+};
+
+void TestFragmentIndex::completeFile()
+{
+    FragmentIndex index;
+    QVERIFY2(index.build(fixture("complete.m4s")), qPrintable(index.errorString()));
+    QVERIFY(index.isFragmented());
+    QVERIFY(!index.isTruncated());
+    QCOMPARE(index.handlerType(), QByteArray("vide"));
+    QCOMPARE(index.timescale(), 1000u);
+    QCOMPARE(index.width(), 1920);
+    QCOMPARE(index.height(), 1080);
+    QCOMPARE(index.fragments().size(), 2);
+    QCOMPARE(index.completeFragmentCount(), 2);
+    QCOMPARE(index.totalSampleCount(), quint64(4));
+    QCOMPARE(index.fragments()[1].startTime, quint64(2000));
+    QCOMPARE(index.playableDuration(), 4.0);
+    QCOMPARE(index.declaredDuration(), 4.0);
+
+    QVERIFY(!SourceIntegrity::check(fixture("complete.m4s")).isTruncated());
+}
+
+void TestFragmentIndex::truncatedLastMdat()
+{
+    FragmentIndex index;
+    QVERIFY(index.build(fixture("truncated_mdat.m4s")));
+    QVERIFY(index.isTruncated());
+    QCOMPARE(index.missingTailBytes(), qint64(6));
+    QCOMPARE(index.fragments().size(), 2);
+    QVERIFY(!index.fragments().last().complete);
+    QCOMPARE(index.completeFragmentCount(), 1);
+    QCOMPARE(index.playableDuration(), 2.0);
+
+    const SourceIntegrity integrity = SourceIntegrity::check(fixture("truncated_mdat.m4s"));
+    QVERIFY(integrity.isTruncated());
+    QCOMPARE(integrity.fragmentEnds, QList<double>({2.0}));
+}
+
+void TestFragmentIndex::truncatedLastMoof()
+{
+    FragmentIndex index;
+    QVERIFY(index.build(fixture("truncated_moof.m4s")));
+    QVERIFY(index.isTruncated());
+    QVERIFY(index.missingTailBytes() > 0);
+    // 不完整的 moof 也记为一个分片，但不计入可播放时长
+    QCOMPARE(index.fragments().size(), 2);
+    QCOMPARE(index.completeFragmentCount(), 1);
+    QCOMPARE(index.totalSampleCount(), quint64(2));
+    QCOMPARE(index.playableDuration(), 2.0);
+}
+
+void TestFragmentIndex::trunCountOverflow()
+{
+    // trun 声明 0x40000000 个样本：不能按该数循环，分片按不完整处理
+    FragmentIndex index;
+    QVERIFY(index.build(fixture("trun_overflow.m4s")));
+    QVERIFY(!index.isTruncated());
+    QCOMPARE(index.fragments().size(), 2);
+    QCOMPARE(index.completeFragmentCount(), 1);
+    QCOMPARE(index.fragments()[1].sampleCount, 0u);
+    QCOMPARE(index.totalSampleCount(), quint64(2));
+    QCOMPARE(index.playableDuration(), 2.0);
+
+    QVERIFY(SourceIntegrity::check(fixture("trun_overflow.m4s")).isTruncated());
+}
+
+void TestFragmentIndex::sidxDurationMismatch()
+{
+    // 文件在分片边界处中断：盒子都完整，只有 sidx 声明的时长能说明缺少后续分片
+    FragmentIndex index;
+    QVERIFY(index.build(fixture("sidx_mismatch.m4s")));
+    QVERIFY(!index.isTruncated());
+    QCOMPARE(index.completeFragmentCount(), 2);
+    QCOMPARE(index.playableDuration(), 4.0);
+    QCOMPARE(index.declaredDuration(), 10.0);
+
+    const SourceIntegrity integrity = SourceIntegrity::check(fixture("sidx_mismatch.m4s"));
+    QCOMPARE(integrity.missingTailBytes, qint64(0));
+    QCOMPARE(integrity.completeFragments, integrity.totalFragments);
+    QVERIFY(integrity.isTruncated());
+    QVERIFY(integrity.summary().contains("10.0"));
+}
+
+void TestFragmentIndex::salvageStopsAtCompleteFragment()
+{
+    const SourceIntegrity video = SourceIntegrity::check(fixture("truncated_mdat.m4s"));
+    const SourceIntegrity audio = SourceIntegrity::check(fixture("complete.m4s"));
+    QCOMPARE(SourceIntegrity::salvageDuration(video, audio), 2.0);
+    QCOMPARE(SourceIntegrity::salvageDuration(audio, video), 2.0);
+}
+
+QTEST_APPLESS_MAIN(TestFragmentIndex)
+#include "tst_fragmentindex.moc"
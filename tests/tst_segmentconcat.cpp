@@ -0,0 +1,53 @@
+#include <QtTest>
+#include "media/segmentconcat.h"
+
+class TestSegmentConcat : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QStringList fileNames(const QStringList& paths);
+
+private slots:
+    void numericOrder();
+    void qualitySubdirectory();
+    void concatListQuotesPaths();
+};
+
+QStringList TestSegmentConcat::fileNames(const QStringList& paths)
+{
+    QStringList names;
+    for (const QString& path : paths) {
+        names << QFileInfo(path).fileName();
+    }
+    return names;
+}
+
+void TestSegmentConcat::numericOrder()
+{
+    // 按段号而不是字典序排序；没有段号的 flv 不是分段
+    const QDir dir(QFINDTESTDATA("fixtures/segments"));
+    QCOMPARE(fileNames(SegmentConcat::findSegments(dir)),
+             QStringList({"0.blv", "1.blv", "2.blv", "10.blv"}));
+}
+
+void TestSegmentConcat::qualitySubdirectory()
+{
+    // 安卓缓存的分段在清晰度子目录中，取段数最多的一个
+    const QDir dir(QFINDTESTDATA("fixtures/segments_android"));
+    const QStringList segments = SegmentConcat::findSegments(dir);
+    QCOMPARE(fileNames(segments),
+             QStringList({"video_0.flv", "video_1.flv", "video_2.flv", "video_9.flv", "video_10.flv", "video_11.flv"}));
+    QVERIFY(segments.first().contains("lua.flv.bili2api.80"));
+}
+
+void TestSegmentConcat::concatListQuotesPaths()
+{
+    // 路径转为绝对路径，单引号写作 '\''
+    const QByteArray list = SegmentConcat::buildConcatList({"it's/0.blv"});
+    QVERIFY(list.startsWith("ffconcat version 1.0\nfile '"));
+    QVERIFY(list.endsWith(R"(/it'\''s/0.blv')" "\n"));
+}
+
+QTEST_APPLESS_MAIN(TestSegmentConcat)
+#include "tst_segmentconcat.moc"